@@ -110,6 +110,10 @@ about_check_schema_updates = Check Schema &Updates
 
 update_current_schema_from_asskit = Update currently loaded Schema with Assembly Kit
 generate_schema_diff = Generate Schema Diff
+debug_toggle_instrumentation = Enable Widget Instrumentation
+debug_show_instrumentation = Show Widget Instrumentation
+debug_reset_instrumentation = Reset Widget Instrumentation
+debug_instrumentation_empty = Nothing recorded yet. Enable the instrumentation and use the UI for a bit before checking it.
 
 ### app_ui_extra.rs localisation
 
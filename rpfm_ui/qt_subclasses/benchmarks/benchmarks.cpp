@@ -0,0 +1,487 @@
+// Benchmarks of the hot paths of qt_subclasses, over synthetic models of realistic sizes.
+//
+// Every case runs a few times. Building the models and the proxies is done outside the timers, so only the measured work counts.
+// Results are written as JSON, to stdout or to the file passed with --output:
+//
+// {
+//     "format": 1,
+//     "qt_version": "5.15.2",
+//     "threads": 8,
+//     "results": [
+//         { "name": "table_filter_literal", "layout": "db", "rows": 100000, "iterations": 5, "items": 100000,
+//           "min_ms": 10.1, "median_ms": 10.4, "mean_ms": 10.6, "items_per_second": 9615384.6 },
+//         ...
+//     ]
+// }
+//
+// Table filters keep the threshold of the parallel passes the UI uses. Each measured filter includes waiting for its pass
+// to finish and to be installed, and walking the rows the proxy ends up showing, so every case is timed until its results are visible.
+
+#include "cell_status.h"
+#include "extended_q_styled_item_delegate.h"
+#include "table_data_loader.h"
+#include "tableview_filter.h"
+#include "treeview_filter.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFontMetrics>
+#include <QHash>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QStandardItemModel>
+#include <QStyleOptionViewItem>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+// Words the synthetic texts are made of.
+static const char* const WORDS[] = {
+    "the", "unit", "flame", "of", "sword", "cavalry", "empire", "chaos", "spear", "lord", "battle", "with", "armoured",
+    "warriors", "dwarf", "greenskin", "and", "missile", "ranged", "siege", "ogre", "night", "mounted", "regiment"
+};
+static const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+// Column mixes of the synthetic tables: loc-like (key, text, tooltip) and DB-like (a mix of every type).
+enum class TableLayout {
+    Loc,
+    Db
+};
+
+// Function to get the name of a layout, as it shows up in the results.
+static QString layoutName(TableLayout layout) {
+    return layout == TableLayout::Loc ? QStringLiteral("loc") : QStringLiteral("db");
+}
+
+// Function to get the column types of a layout, as TableDataLoader expects them.
+static QList<int> layoutColumnTypes(TableLayout layout) {
+    if (layout == TableLayout::Loc) {
+        return {4, 4, 0};
+    }
+
+    return {4, 4, 1, 1, 3, 0, 4, 2};
+}
+
+// Function to append a fixed-size value to a packed table.
+template <typename T> static void appendValue(QByteArray &buffer, T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Function to append a text to a packed table.
+static void appendText(QByteArray &buffer, const QString &text) {
+    const QByteArray utf8 = text.toUtf8();
+    appendValue<quint32>(buffer, static_cast<quint32>(utf8.size()));
+    buffer.append(utf8);
+}
+
+// Function to build a sentence of random words.
+static QString sentence(QRandomGenerator &random, int min_words, int max_words) {
+    QStringList words;
+    const int count = random.bounded(min_words, max_words + 1);
+    for (int word = 0; word < count; ++word) {
+        words.append(QString::fromLatin1(WORDS[random.bounded(WORD_COUNT)]));
+    }
+
+    return words.join(QLatin1Char(' '));
+}
+
+// Function to build a synthetic table, the same way the UI loads them. The generator is seeded, so every run gets the same table.
+//
+// Some cells get marked as modified or with errors, like after editing and checking the table, so the delegates have marks to paint.
+static QStandardItemModel* buildTable(TableLayout layout, int rows) {
+    QRandomGenerator random(static_cast<quint32>(rows));
+    QByteArray buffer;
+
+    for (int row = 0; row < rows; ++row) {
+        if (layout == TableLayout::Loc) {
+            appendText(buffer, QStringLiteral("land_units_onscreen_name_%1").arg(row));
+            appendText(buffer, sentence(random, 3, 12));
+            appendValue<quint8>(buffer, random.bounded(2));
+        } else {
+            appendText(buffer, QStringLiteral("wh_main_unit_name_%1").arg(row));
+            appendText(buffer, QStringLiteral("faction_%1").arg(random.bounded(97)));
+            appendValue<qint32>(buffer, random.bounded(10000));
+            appendValue<qint32>(buffer, random.bounded(-100, 100));
+            appendValue<float>(buffer, static_cast<float>(random.generateDouble() * 100.0));
+            appendValue<quint8>(buffer, random.bounded(2));
+            appendText(buffer, sentence(random, 5, 30));
+            appendValue<qint64>(buffer, static_cast<qint64>(random.generate64() >> 1));
+        }
+    }
+
+    QStandardItemModel* model = new QStandardItemModel();
+    TableDataLoader loader(buffer.constData(), buffer.size(), layoutColumnTypes(layout));
+    loader.loadInto(model, rows, {0}, true, QStringLiteral("%1"), QStringLiteral("sequence"));
+
+    for (int row = 0; row < rows; row += 7) {
+        QStandardItem* item = model->item(row, 1);
+        item->setData(QVariant(true), 22);
+        item->setData(QVariant(item->data(CELL_STATUS_ROLE).toUInt() | CELL_STATUS_MODIFIED), CELL_STATUS_ROLE);
+    }
+
+    for (int row = 0; row < rows; row += 11) {
+        QStandardItem* item = model->item(row, 0);
+        item->setData(QVariant(item->data(CELL_STATUS_ROLE).toUInt() | CELL_STATUS_ERROR), CELL_STATUS_ROLE);
+    }
+
+    return model;
+}
+
+// Function to build a synthetic pack tree, with files spread over a deep folder hierarchy.
+//
+// Files go in groups of 24 per folder, and folders are nested 6 levels deep, with up to 6 subfolders each.
+static QStandardItemModel* buildTree(int files) {
+    static const char* const FOLDERS[] = { "db", "variants", "unit_cards", "campaign", "battle", "textures" };
+    static const char* const EXTENSIONS[] = { "xml", "txt", "png", "dds", "loc", "rigid_model_v2" };
+    const int depth = 6;
+
+    QStandardItemModel* model = new QStandardItemModel();
+    QStandardItem* pack = new QStandardItem(QStringLiteral("data.pack"));
+    pack->setData(QVariant(3), 20);
+    model->appendRow(pack);
+
+    QHash<QString, QStandardItem*> folders;
+    for (int file = 0; file < files; ++file) {
+        QStandardItem* parent = pack;
+        QString path;
+        int value = file / 24;
+        for (int level = 0; level < depth; ++level) {
+            path += QStringLiteral("/%1_%2").arg(QString::fromLatin1(FOLDERS[level])).arg(value % 6);
+            value /= 6;
+
+            QStandardItem* &folder = folders[path];
+            if (folder == nullptr) {
+                folder = new QStandardItem(path.mid(path.lastIndexOf(QLatin1Char('/')) + 1));
+                folder->setData(QVariant(2), 20);
+                parent->appendRow(folder);
+            }
+            parent = folder;
+        }
+
+        QStandardItem* item = new QStandardItem(QStringLiteral("%1_%2.%3").arg(QString::fromLatin1(WORDS[file % WORD_COUNT])).arg(file).arg(QString::fromLatin1(EXTENSIONS[file % 6])));
+        item->setData(QVariant(1), 20);
+        parent->appendRow(item);
+    }
+
+    return model;
+}
+
+// Function to walk all the visible nodes of a proxy, like a fully expanded view would. Returns the amount of nodes.
+static int countVisibleNodes(const QAbstractItemModel* proxy, const QModelIndex &parent) {
+    int count = 0;
+    const int rows = proxy->rowCount(parent);
+    for (int row = 0; row < rows; ++row) {
+        count += 1 + countVisibleNodes(proxy, proxy->index(row, 0, parent));
+    }
+
+    return count;
+}
+
+// Function to wait for the parallel filter passes still running, and to install their results. Installing a pass may
+// start a new one, if the source changed meanwhile, so this loops until there is nothing left to wait for.
+static void finishFilterPasses() {
+    do {
+        QThreadPool::globalInstance()->waitForDone();
+        QCoreApplication::processEvents();
+    } while (QThreadPool::globalInstance()->activeThreadCount() > 0);
+}
+
+// Runner of the benchmark cases, collecting their results.
+class BenchmarkRunner {
+
+public:
+    int iterations = 5;
+    QString case_filter;
+    QJsonArray results;
+
+    // Function to run a case. setup runs before each iteration, outside the timer, and work is what gets measured.
+    // items is the amount of things (rows, nodes, cells) one run of work processes, to get the throughput.
+    void run(const QString &name, const QString &layout, int rows, qint64 items, const std::function<void()> &setup, const std::function<void()> &work) {
+        if (!case_filter.isEmpty() && !name.contains(case_filter)) {
+            return;
+        }
+
+        QTextStream(stderr) << "Running " << name << " (" << layout << ", " << rows << " rows)..." << Qt::endl;
+
+        std::vector<double> timings;
+        timings.reserve(iterations);
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            setup();
+
+            QElapsedTimer timer;
+            timer.start();
+            work();
+            timings.push_back(static_cast<double>(timer.nsecsElapsed()) / 1000000.0);
+        }
+
+        std::sort(timings.begin(), timings.end());
+        double total = 0.0;
+        for (double timing: timings) {
+            total += timing;
+        }
+
+        const double median = timings.at(timings.size() / 2);
+        QJsonObject result;
+        result["name"] = name;
+        result["layout"] = layout;
+        result["rows"] = rows;
+        result["iterations"] = iterations;
+        result["items"] = static_cast<double>(items);
+        result["min_ms"] = timings.front();
+        result["median_ms"] = median;
+        result["mean_ms"] = total / timings.size();
+        result["items_per_second"] = median > 0.0 ? static_cast<double>(items) / (median / 1000.0) : 0.0;
+        results.append(result);
+    }
+};
+
+// A table filter case: the same arguments trigger_tableview_filter gets.
+struct TableFilterCase {
+    QString name;
+    QList<int> columns;
+    QStringList patterns;
+    QList<int> case_sensitive;
+    QList<int> match_groups;
+
+    FilterPlan plan() const {
+        QList<int> show_blank_cells;
+        for (int column = 0; column < columns.count(); ++column) {
+            show_blank_cells.append(0);
+        }
+        return FilterPlan::build(columns, patterns, case_sensitive, show_blank_cells, match_groups);
+    }
+};
+
+// Function to get the filter cases of a layout.
+static QList<TableFilterCase> tableFilterCases(TableLayout layout) {
+    if (layout == TableLayout::Loc) {
+        return {
+            {"table_filter_literal", {0}, {"name_12"}, {0}, {0}},
+            {"table_filter_regex", {0}, {"^land_units_[a-z]+_name_1[0-9]*5$"}, {1}, {0}},
+            {"table_filter_text_column", {1}, {"flame"}, {0}, {0}},
+            {"table_filter_multi_column", {1, 2}, {"the", "false"}, {0, 0}, {0, 0}},
+        };
+    }
+
+    return {
+        {"table_filter_literal", {0}, {"name_12"}, {0}, {0}},
+        {"table_filter_regex", {0}, {"^wh_main_[a-z]+_name_1[0-9]*5$"}, {1}, {0}},
+        {"table_filter_text_column", {6}, {"flame"}, {0}, {0}},
+        {"table_filter_multi_column", {1, 5}, {"faction_1", "true"}, {0, 0}, {0, 0}},
+        {"table_filter_groups", {1, 1}, {"faction_1", "faction_2"}, {0, 0}, {0, 1}},
+    };
+}
+
+// Function to run all the table cases (filters, sorts and painting) over a table.
+static void runTableCases(BenchmarkRunner &runner, TableLayout layout, int rows) {
+    const QString layout_name = layoutName(layout);
+    QStandardItemModel* model = nullptr;
+    QTableViewSortFilterProxyModel* proxy = nullptr;
+
+    // Every iteration gets a new proxy, so nothing cached by the previous one helps. The proxy builds its mapping on first use,
+    // like it does once a view shows it, so filters and sorts have something to re-filter and re-sort.
+    auto new_proxy = [&]() {
+        delete proxy;
+        proxy = new QTableViewSortFilterProxyModel();
+        proxy->setSourceModel(model);
+        proxy->rowCount();
+    };
+
+    runner.run("table_load", layout_name, rows, rows, [&]() {
+        delete proxy;
+        proxy = nullptr;
+        delete model;
+        model = nullptr;
+    }, [&]() {
+        model = buildTable(layout, rows);
+    });
+
+    if (model == nullptr) {
+        model = buildTable(layout, rows);
+    }
+
+    for (const TableFilterCase &filter_case: tableFilterCases(layout)) {
+        const FilterPlan plan = filter_case.plan();
+        runner.run(filter_case.name, layout_name, rows, rows, new_proxy, [&]() {
+            proxy->setFilterPlan(plan);
+            finishFilterPasses();
+            countVisibleNodes(proxy, QModelIndex());
+        });
+    }
+
+    // Typing a filter, one character at a time, so each pass can narrow the previous one.
+    const QString typed = QStringLiteral("name_12");
+    runner.run("table_filter_typing", layout_name, rows, static_cast<qint64>(rows) * typed.size(), new_proxy, [&]() {
+        for (int length = 1; length <= typed.size(); ++length) {
+            TableFilterCase filter_case = {QString(), {0}, {typed.left(length)}, {0}, {0}};
+            proxy->setFilterPlan(filter_case.plan());
+            finishFilterPasses();
+            countVisibleNodes(proxy, QModelIndex());
+        }
+    });
+
+    // Sorts, from a new proxy and re-sorting an already sorted column.
+    const int numeric_column = 2;
+    runner.run("table_sort_text", layout_name, rows, rows, new_proxy, [&]() {
+        proxy->sort(1, Qt::AscendingOrder);
+    });
+
+    runner.run("table_sort_numeric", layout_name, rows, rows, new_proxy, [&]() {
+        proxy->sort(numeric_column, Qt::AscendingOrder);
+    });
+
+    runner.run("table_sort_reverse", layout_name, rows, rows, [&]() {
+        new_proxy();
+        proxy->sort(1, Qt::AscendingOrder);
+    }, [&]() {
+        proxy->sort(1, Qt::DescendingOrder);
+    });
+
+    // Painting a few screens of cells offscreen, through the proxy, like a view does.
+    new_proxy();
+    const int painted_rows = qMin(rows, 1000);
+    const int columns = model->columnCount();
+    const int column_width = 160;
+    const int row_height = 24;
+    QImage image(column_width * columns, row_height, QImage::Format_ARGB32_Premultiplied);
+    QExtendedStyledItemDelegate delegate(nullptr, nullptr, false, true, true);
+    runner.run("delegate_paint", layout_name, rows, static_cast<qint64>(painted_rows) * columns, []() {}, [&]() {
+        QPainter painter(&image);
+        QStyleOptionViewItem option;
+        option.state = QStyle::State_Enabled;
+        option.palette = QApplication::palette();
+        option.font = QApplication::font();
+        option.fontMetrics = QFontMetrics(option.font);
+        for (int row = 0; row < painted_rows; ++row) {
+            for (int column = 0; column < columns; ++column) {
+                option.rect = QRect(column * column_width, 0, column_width, row_height);
+                delegate.paint(&painter, option, proxy->index(row, column));
+            }
+        }
+    });
+
+    delete proxy;
+    delete model;
+}
+
+// A tree filter case: the same arguments trigger_treeview_filter_pattern gets.
+struct TreeFilterCase {
+    QString name;
+    QString pattern;
+    Qt::CaseSensitivity case_sensitivity;
+};
+
+// Function to run all the tree filter cases over a tree. Each pass also walks the visible nodes, like a fully expanded view.
+static void runTreeCases(BenchmarkRunner &runner, int files) {
+    const QString layout_name = QStringLiteral("pack_tree");
+    QStandardItemModel* model = buildTree(files);
+    QTreeViewSortFilterProxyModel* proxy = nullptr;
+    int nodes = 0;
+
+    auto new_proxy = [&]() {
+        delete proxy;
+        proxy = new QTreeViewSortFilterProxyModel();
+        proxy->setSourceModel(model);
+        proxy->rowCount();
+    };
+
+    new_proxy();
+    nodes = countVisibleNodes(proxy, QModelIndex());
+
+    const QList<TreeFilterCase> cases = {
+        {"tree_filter_contains", "unit", Qt::CaseSensitivity::CaseInsensitive},
+        {"tree_filter_prefix", "^variants", Qt::CaseSensitivity::CaseSensitive},
+        {"tree_filter_suffix", ".xml$", Qt::CaseSensitivity::CaseSensitive},
+        {"tree_filter_regex", "unit.*_1[0-9]+\\.(xml|txt)$", Qt::CaseSensitivity::CaseInsensitive},
+    };
+
+    for (const TreeFilterCase &filter_case: cases) {
+        runner.run(filter_case.name, layout_name, files, nodes, new_proxy, [&]() {
+            proxy->setFilterPattern(filter_case.pattern, filter_case.case_sensitivity);
+            countVisibleNodes(proxy, QModelIndex());
+        });
+    }
+
+    const QString typed = QStringLiteral("unit_12");
+    runner.run("tree_filter_typing", layout_name, files, static_cast<qint64>(nodes) * typed.size(), new_proxy, [&]() {
+        for (int length = 1; length <= typed.size(); ++length) {
+            proxy->setFilterPattern(typed.left(length), Qt::CaseSensitivity::CaseInsensitive);
+            countVisibleNodes(proxy, QModelIndex());
+        }
+    });
+
+    delete proxy;
+    delete model;
+}
+
+int main(int argc, char *argv[]) {
+
+    // Painting doesn't need a screen.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QApplication::setApplicationName(QStringLiteral("qt_subclasses_benchmarks"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Benchmarks of the table and tree proxies and the delegates of qt_subclasses."));
+    parser.addHelpOption();
+
+    QCommandLineOption sizes_option(QStringLiteral("sizes"), QStringLiteral("Comma-separated sizes (rows or files) of the synthetic models."), QStringLiteral("sizes"), QStringLiteral("10000,100000,1000000"));
+    QCommandLineOption iterations_option(QStringLiteral("iterations"), QStringLiteral("Times each case runs."), QStringLiteral("count"), QStringLiteral("5"));
+    QCommandLineOption cases_option(QStringLiteral("cases"), QStringLiteral("Only run the cases with this text in their name."), QStringLiteral("text"));
+    QCommandLineOption output_option(QStringLiteral("output"), QStringLiteral("File to write the results to, instead of stdout."), QStringLiteral("file"));
+    parser.addOption(sizes_option);
+    parser.addOption(iterations_option);
+    parser.addOption(cases_option);
+    parser.addOption(output_option);
+    parser.process(app);
+
+    QList<int> sizes;
+    for (const QString &size: parser.value(sizes_option).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        bool ok = false;
+        int value = size.trimmed().toInt(&ok);
+        if (ok && value > 0) {
+            sizes.append(value);
+        }
+    }
+
+    BenchmarkRunner runner;
+    runner.iterations = qMax(1, parser.value(iterations_option).toInt());
+    runner.case_filter = parser.value(cases_option);
+
+    for (int size: sizes) {
+        runTableCases(runner, TableLayout::Loc, size);
+        runTableCases(runner, TableLayout::Db, size);
+        runTreeCases(runner, size);
+    }
+
+    QJsonObject report;
+    report["format"] = 1;
+    report["qt_version"] = QString::fromLatin1(qVersion());
+    report["threads"] = QThreadPool::globalInstance()->maxThreadCount();
+    report["results"] = runner.results;
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(output_option)) {
+        QFile file(parser.value(output_option));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Couldn't open " << file.fileName() << " for writing." << Qt::endl;
+            return 1;
+        }
+        file.write(json);
+    } else {
+        QTextStream(stdout) << json;
+    }
+
+    return 0;
+}
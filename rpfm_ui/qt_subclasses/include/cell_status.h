@@ -0,0 +1,26 @@
+#ifndef CELL_STATUS_H
+#define CELL_STATUS_H
+
+#include "qt_subclasses_global.h"
+#include <QModelIndex>
+#include <QVariant>
+
+// Role holding the status of a cell as a bitmask of the CELL_STATUS_* bits, so it can be read with a single data() call.
+//
+// It's stored on the items themselves, next to the individual roles Rust reads (20 for keys, 21 added and 22 modified).
+// Whatever changes the status of a cell has to update it too: the table loader, the diagnostics, and the edits from Rust.
+const int CELL_STATUS_ROLE = 40;
+
+const quint8 CELL_STATUS_KEY = 1;
+const quint8 CELL_STATUS_ADDED = 2;
+const quint8 CELL_STATUS_MODIFIED = 4;
+const quint8 CELL_STATUS_ERROR = 8;
+const quint8 CELL_STATUS_WARNING = 16;
+const quint8 CELL_STATUS_INFO = 32;
+
+// Function to get the status bitmask of a cell. Cells without CELL_STATUS_ROLE have no status.
+inline quint8 cell_status(const QModelIndex &index) {
+    return static_cast<quint8>(index.data(CELL_STATUS_ROLE).toUInt());
+}
+
+#endif // CELL_STATUS_H
@@ -3,12 +3,16 @@
 
 #include "qt_subclasses_global.h"
 #include "extended_q_styled_item_delegate.h"
+#include "reference_list_registry.h"
 #include <QStyledItemDelegate>
 #include <QAbstractItemDelegate>
 #include <QComboBox>
+#include <QCompleter>
+#include <QStringListModel>
 #include <QTimer>
 
 extern "C" void new_combobox_item_delegate(QObject *parent = nullptr, const int column = 0, const QStringList *values = nullptr, const bool is_editable = false, const int max_lenght = 0, QTimer* timer = nullptr, bool is_dark_theme_enabled = false, bool has_filter = false, bool right_side_mark = false);
+extern "C" void new_combobox_item_delegate_shared(QObject *parent = nullptr, const int column = 0, const int reference_list = -1, const bool is_editable = false, const int max_lenght = 0, QTimer* timer = nullptr, bool is_dark_theme_enabled = false, bool has_filter = false, bool right_side_mark = false);
 
 class QComboBoxItemDelegate : public QExtendedStyledItemDelegate
 {
@@ -17,18 +21,35 @@ class QComboBoxItemDelegate : public QExtendedStyledItemDelegate
 public:
 
     explicit QComboBoxItemDelegate(QObject *parent = nullptr, const QStringList list = {""}, bool is_editable = false, int max_lenght = 0, QTimer* timer = nullptr, bool is_dark_theme_enabled = false, bool has_filter = false, bool right_side_mark = false);
+    ~QComboBoxItemDelegate() override;
 
     QWidget* createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    void destroyEditor(QWidget *editor, const QModelIndex &index) const override;
     void setEditorData(QWidget *editor, const QModelIndex &index) const;
     void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const;
     void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    void useReferenceList(int handle);
 
 signals:
 
 private:
-    QStringList values;
+
+    // Values of the combo, shared by all its editors, so opening one doesn't need to copy them.
+    QStringListModel* values_model;
+
+    // Completer for editable combos. It's shared too, as there's only one editor open at once.
+    QCompleter* completer;
+
+    // Handle of the list of the ReferenceListRegistry this delegate shows, or -1 if its values are its own.
+    int reference_list = -1;
+
+    // Rows temporarily added to the values for the open editors. While there are any, updates of the list are postponed.
+    mutable int inserted_rows = 0;
+    mutable bool reference_list_outdated = false;
     bool editable;
     int max_lenght;
     QTimer* diag_timer;
+
+    void reloadReferenceList() const;
 };
 #endif // COMBOBOX_ITEM_DELEGATE_H
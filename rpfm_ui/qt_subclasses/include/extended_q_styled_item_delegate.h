@@ -2,10 +2,16 @@
 #define EXTENDED_Q_STYLED_ITEM_DELEGATE_H
 
 #include "qt_subclasses_global.h"
+#include "cell_status.h"
+#include "theme_palette.h"
 #include <QStyledItemDelegate>
 #include <QAbstractItemDelegate>
 #include <QTimer>
 #include <QColor>
+#include <QList>
+#include <QPen>
+#include <QPointer>
+#include <QSharedPointer>
 
 extern "C" void new_generic_item_delegate(QObject *parent = nullptr, const int column = 0, QTimer* timer = nullptr, bool is_dark_theme_enabled = false, bool has_filter = false, bool right_side_mark = false);
 
@@ -15,7 +21,9 @@ Q_OBJECT
 public:
 
     explicit QExtendedStyledItemDelegate(QObject *parent = nullptr, QTimer* timer = nullptr, bool is_dark_theme_enabled = false, bool has_filter = false, bool right_side_mark = false);
+    ~QExtendedStyledItemDelegate() override;
     QWidget* createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const;
+    void destroyEditor(QWidget *editor, const QModelIndex &index) const override;
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
 
 signals:
@@ -24,14 +32,24 @@ protected:
     bool dark_theme;
     bool use_filter;
     bool use_right_side_mark;
-    QColor colour_table_added;
-    QColor colour_table_modified;
-    QColor colour_diagnostic_error;
-    QColor colour_diagnostic_warning;
-    QColor colour_diagnostic_info;
+
+    // If editors are kept and reused once the edition ends, instead of being destroyed.
+    // Only for delegates whose editors don't depend on the index they're created for.
+    bool pool_editors = false;
+
+    const ThemePalette &themePalette() const;
+    QWidget* takePooledEditor(QWidget *parent) const;
+    void drawMark(QPainter *painter, const QStyleOptionViewItem &option, const QPen &pen) const;
 
 private:
     QTimer* diag_timer;
+
+    // Palette shared with all the other delegates, and the generation it belongs to.
+    mutable QSharedPointer<const ThemePalette> palette;
+    mutable int palette_generation = -1;
+
+    // Editors waiting to be reused. They belong to the viewport, so they may get destroyed while in here.
+    mutable QList<QPointer<QWidget>> editor_pool;
 };
 
 #endif // EXTENDED_Q_STYLED_ITEM_DELEGATE_H
@@ -0,0 +1,56 @@
+#ifndef FILTER_SCHEDULER_H
+#define FILTER_SCHEDULER_H
+
+#include "qt_subclasses_global.h"
+#include <QAtomicInt>
+#include <QObject>
+#include <QSharedPointer>
+#include <QTimer>
+#include <functional>
+
+extern "C" void set_filter_debounce(QObject* filter = nullptr, int msec = 0);
+
+// Token of a filter pass running in the background. Workers have to check it every now and then, and stop once it gets cancelled.
+class FilterCancelToken {
+
+public:
+    FilterCancelToken(): cancelled(new QAtomicInt(0)) {}
+
+    bool isCancelled() const { return cancelled->loadAcquire() != 0; }
+    void cancel() const { cancelled->storeRelease(1); }
+
+private:
+    QSharedPointer<QAtomicInt> cancelled;
+};
+
+// Scheduler of the filter passes of a proxy model. Proxies own one as a child.
+//
+// - Passes requested within the debounce window get merged: only the last one runs, once the window is over. Without window, they run right away.
+// - Every pass that begins gets a new generation, and cancels the token of the previous one. Results from older generations have to be dropped,
+//   so the last valid result stays on screen until a newer one is ready.
+class FilterScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FilterScheduler(QObject* parent = nullptr);
+
+    void setDebounce(int msec);
+    int debounce() const { return debounce_msec; }
+
+    void schedule(const std::function<void()> &pass);
+    void flush();
+    void cancel();
+
+    int beginPass();
+    bool isCurrent(int generation) const { return generation == current_generation; }
+    FilterCancelToken token() const { return current_token; }
+
+private:
+    QTimer* timer;
+    int debounce_msec = 0;
+    std::function<void()> pending_pass;
+    int current_generation = 0;
+    FilterCancelToken current_token;
+};
+
+#endif // FILTER_SCHEDULER_H
@@ -0,0 +1,43 @@
+#ifndef FUZZY_MATCHER_H
+#define FUZZY_MATCHER_H
+
+#include "qt_subclasses_global.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// A candidate that matched a query, with its score. Higher is better.
+struct FuzzyMatch {
+    int index;
+    int score;
+};
+
+// Fuzzy matcher over a fixed list of candidates (actions, paths, table names...), for the command palette.
+//
+// Everything not depending on the query is computed once, when the candidates are set:
+// - The lowercase text of all candidates, in a single buffer, with offsets[i] and offsets[i + 1] delimiting each one.
+// - A bitmask of the positions starting a word (after a separator, or on a lowercase-uppercase change), where matches score more.
+// - A bag of the characters of each candidate, so candidates missing any character of the query are rejected without reading them.
+//
+// Queries are scored in parallel, with each worker keeping only its best results in a bounded heap.
+class FuzzyMatcher {
+
+public:
+    void setCandidates(const QStringList &candidates);
+    int count() const { return bags.count(); }
+
+    QVector<FuzzyMatch> match(const QString &query, int limit) const;
+    int score(int candidate, const QString &lower_query, quint64 query_bag) const;
+
+    static quint64 characterBag(const QString &lower_text);
+
+private:
+    QString text;
+    QVector<int> offsets;
+    QVector<quint64> boundaries;
+    QVector<quint64> bags;
+
+    bool isBoundary(int position) const { return (boundaries.at(position >> 6) >> (position & 63)) & 1; }
+};
+
+#endif // FUZZY_MATCHER_H
@@ -0,0 +1,63 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include "qt_subclasses_global.h"
+#include <QAtomicInt>
+#include <QString>
+#include <chrono>
+
+extern "C" void set_instrumentation_enabled(bool enabled = false);
+extern "C" bool is_instrumentation_enabled();
+extern "C" void get_instrumentation_snapshot(QString* snapshot = nullptr);
+extern "C" void reset_instrumentation();
+
+// Hot paths with a probe. Each one keeps its own counters.
+enum class InstrumentationProbe {
+    TableFilterAcceptsRow,
+    TableLessThan,
+    TableFilterPass,
+    TableFilterWorker,
+    TreeFilterAcceptsRow,
+    TreeFilterPass,
+    DelegatePaint,
+    DelegateCreateEditor,
+    TextEditorSetText,
+    TextEditorGetText,
+    TriggerTableFilter,
+    TriggerTreeFilter,
+    Count
+};
+
+// Switch of the instrumentation. It's off by default, and while it's off, it's the only thing the probes touch.
+extern QAtomicInt instrumentation_enabled;
+
+void recordInstrumentation(InstrumentationProbe probe, qint64 duration_ns);
+
+// Scoped timer of a probe: it records a call, with the time between its construction and its destruction.
+//
+// Probes are kept process-wide and updated with atomics, so they work from the filter workers too. The durations go into
+// a histogram with one bucket per power of two of nanoseconds, which is enough to tell a slow path from a slow call.
+class InstrumentationScope {
+
+public:
+    explicit InstrumentationScope(InstrumentationProbe probe): probe(probe), enabled(instrumentation_enabled.loadRelaxed() != 0) {
+        if (enabled) {
+            started = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~InstrumentationScope() {
+        if (enabled) {
+            recordInstrumentation(probe, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started).count());
+        }
+    }
+
+    Q_DISABLE_COPY(InstrumentationScope)
+
+private:
+    InstrumentationProbe probe;
+    bool enabled;
+    std::chrono::steady_clock::time_point started;
+};
+
+#endif // INSTRUMENTATION_H
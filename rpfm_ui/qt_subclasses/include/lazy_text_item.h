@@ -0,0 +1,65 @@
+#ifndef LAZY_TEXT_ITEM_H
+#define LAZY_TEXT_ITEM_H
+
+#include "qt_subclasses_global.h"
+#include <QByteArray>
+#include <QCache>
+#include <QSharedPointer>
+#include <QStandardItem>
+#include <QString>
+#include <QVariant>
+
+// Packed texts of a loaded table, shared by all its LazyTextItems.
+//
+// The texts stay in the buffer they came from, as UTF-8 with their length in front, and are only decoded when something asks for them.
+// The last ones decoded are kept in a small LRU cache, so the views scrolling back and forth don't decode them again.
+// The cache is only touched from the GUI thread.
+class LazyTextBuffer {
+
+public:
+
+    // Tooltip of the cells. %1 gets replaced with their source text.
+    QString tooltip_template;
+
+    LazyTextBuffer(const QByteArray &data, const QString &tooltip_template, int cache_size = 4096);
+
+    QString text(qint64 offset, bool use_cache = true) const;
+
+private:
+    QByteArray data;
+    mutable QCache<qint64, QString> decoded_texts;
+};
+
+// Text cell of a table, with its text still packed in a LazyTextBuffer.
+//
+// It answers the roles of the text items the loader used to build (display/edit, source value and tooltip) decoding the text on demand.
+// Once one of those roles gets set, the item keeps that role like any other QStandardItem. The rest of the roles are stored as usual.
+// QStandardItemModel::itemData() reads the stored roles directly, so it doesn't see the decoded ones. The tables don't use it.
+//
+// Each cell is still one QStandardItem, so memory and open time keep growing with the size of the table. Only the decoding
+// of the texts is deferred until something reads them.
+class LazyTextItem : public QStandardItem {
+
+public:
+    static const int Type = QStandardItem::UserType + 1;
+
+    LazyTextItem(const QSharedPointer<const LazyTextBuffer> &buffer, qint64 offset);
+
+    int type() const override { return Type; }
+    QVariant data(int role = Qt::UserRole + 1) const override;
+    void setData(const QVariant &value, int role = Qt::UserRole + 1) override;
+    QStandardItem *clone() const override;
+
+    QString displayText(bool use_cache = true) const;
+
+private:
+    QSharedPointer<const LazyTextBuffer> buffer;
+    qint64 offset;
+
+    // Roles that have been set, so they no longer come from the buffer.
+    quint8 stored_roles = 0;
+
+    static quint8 lazyRole(int role);
+};
+
+#endif // LAZY_TEXT_ITEM_H
@@ -0,0 +1,12 @@
+#ifndef LITERAL_MATCHER_H
+#define LITERAL_MATCHER_H
+
+#include "qt_subclasses_global.h"
+
+// Function to check if a UTF-16 text contains a UTF-16 literal. For case-insensitive searches, both have to be case-folded before calling this.
+//
+// It uses the widest vector instructions the CPU supports (AVX2 or SSE2 on x86, NEON on ARM), choosing them at runtime,
+// with a scalar fallback for everything else.
+bool literal_contains(const ushort *text, int text_length, const ushort *literal, int literal_length);
+
+#endif // LITERAL_MATCHER_H
@@ -2,15 +2,52 @@
 #define PACKED_FILE_MODEL_H
 
 #include "qt_subclasses_global.h"
+#include <QHash>
+#include <QIcon>
+#include <QSharedPointer>
 #include <QStandardItemModel>
+#include <QStringList>
 #include <QStringListModel>
+#include <QVector>
 
 extern "C" QStandardItemModel* new_packed_file_model();
+extern "C" bool packed_file_model_load_lazy(QStandardItemModel* model = nullptr, QStandardItem* root = nullptr, const char* buffer = nullptr, qint64 buffer_size = 0, int count = 0);
+extern "C" void packed_file_model_register_icon(QStandardItemModel* model = nullptr, int id = 0, const QIcon* icon = nullptr);
+extern "C" void packed_file_model_fetch_path(QStandardItemModel* model = nullptr, QStringList* path = nullptr);
+extern "C" void packed_file_model_fetch_all(QStandardItemModel* model = nullptr, QStandardItem* item = nullptr);
 
+// Entry of the path table of a lazy PackedFileModel: a PackedFile, with the data needed to create its item.
+struct PackedFileEntry {
+    QString path;
+    QString tooltip;
+    quint8 icon = 0;
+};
+
+// Model of the PackFile Contents TreeView.
+//
+// It can be loaded lazily: instead of getting the items of the entire PackFile, it gets the sorted list of its PackedFiles (the path table),
+// and the items of each folder are only created once it's needed (expanded, filtered, or reached by a path). Pending folders keep in
+// PENDING_CHILDREN_ROLE the range of the path table with their contents and their depth, so they stay valid if they get moved around.
 class PackedFileModel : public QStandardItemModel {
     Q_OBJECT
 public:
+    explicit PackedFileModel(QObject *parent = nullptr);
     Qt::ItemFlags flags(const QModelIndex &index) const;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    bool loadLazy(QStandardItem* root, const char* buffer, qint64 buffer_size, int count);
+    void registerIcon(int id, const QIcon &icon);
+    bool fetchChildren(QStandardItem* item);
+    void fetchPath(const QStringList &path);
+    void fetchAll(QStandardItem* item = nullptr);
+
+private:
+    QSharedPointer<const QVector<PackedFileEntry>> path_table;
+    QHash<int, QIcon> icons;
+
+    QList<QStandardItem*> newRow(const QString &name, int item_type, const QString &tooltip, int icon) const;
 };
 
 #endif // PACKED_FILE_MODEL_H
@@ -0,0 +1,11 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include "qt_subclasses_global.h"
+#include <functional>
+
+// Function to run the provided worker over the range [0, count) in chunks, using the global QThreadPool.
+// The calling thread runs one of the chunks too, and this returns once all of them are done.
+void parallel_for(int count, int min_chunk_size, const std::function<void(int begin, int end)> &worker);
+
+#endif // PARALLEL_FOR_H
@@ -4,7 +4,6 @@
 #include <QMainWindow>
 #include <QCloseEvent>
 #include <QMessageBox>
-#include <QSettings>
 
 extern "C" QMainWindow* new_q_main_window_custom(bool (*are_you_sure)(QMainWindow* main_window, bool is_delete_my_mod) = nullptr);
 
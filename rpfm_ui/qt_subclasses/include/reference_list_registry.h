@@ -0,0 +1,55 @@
+#ifndef REFERENCE_LIST_REGISTRY_H
+#define REFERENCE_LIST_REGISTRY_H
+
+#include "qt_subclasses_global.h"
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+extern "C" int reference_list_find(QString *key = nullptr, quint64 version = 0);
+extern "C" int reference_list_register(QString *key = nullptr, quint64 version = 0, QStringList *values = nullptr);
+
+// Registry of the lists of values the combobox delegates show, shared between all the views using them.
+//
+// Each list has a key (the table/column it comes from) and a version (anything that changes when its contents change).
+// Delegates hold it by handle, which stays the same for the same key, so they can be told when a new version gets registered.
+// The lists themselves are implicitly shared, so all the delegates using a list point to the same strings until one of them modifies its copy.
+//
+// Delegates acquire the lists they use, and release them when they're destroyed. Once the last delegate using a list releases it,
+// the list is dropped, and registering its key again gives a new handle.
+class ReferenceListRegistry : public QObject {
+    Q_OBJECT
+
+public:
+    static ReferenceListRegistry *instance();
+
+    int find(const QString &key, quint64 version) const;
+    int registerList(const QString &key, quint64 version, const QStringList &values);
+    QStringList values(int handle) const;
+    void acquire(int handle);
+    static void release(int handle);
+
+signals:
+    void listChanged(int handle);
+
+private:
+    struct Entry {
+        QString key;
+        quint64 version = 0;
+        QStringList values;
+        int users = 0;
+    };
+
+    explicit ReferenceListRegistry(QObject *parent = nullptr);
+
+    QHash<QString, int> handles;
+    QHash<int, Entry> entries;
+
+    // Handles are never reused, so a delegate can't end up with a list of another key.
+    int next_handle = 0;
+
+    void releaseList(int handle);
+};
+
+#endif // REFERENCE_LIST_REGISTRY_H
@@ -2,11 +2,19 @@
 #define RESIZABLE_LABEL_H
 
 #include "qt_subclasses_global.h"
+#include <QImage>
 #include <QLabel>
+#include <QList>
+#include <QPixmap>
+#include <QTimer>
 
 extern "C" QLabel* new_resizable_label(QWidget *parent = nullptr, QPixmap *pixmap = nullptr);
 extern "C" void set_pixmap_on_resizable_label(QLabel *label = nullptr, QPixmap *pixmap = nullptr);
 
+// Label that shows a pixmap scaled down to fit it.
+//
+// Scaling big images is slow, so it's done in the background once the resizing stops. Meanwhile, the label shows a quick (unfiltered)
+// scale of the nearest size it has already scaled the image to. The last few sizes are kept, so going back to them is instant.
 class ResizableLabel : public QLabel {
 
 public:
@@ -14,9 +22,32 @@ public:
     virtual int heightForWidth( int width ) const;
     virtual QSize sizeHint() const;
     QPixmap scaledPixmap() const;
+    void setSourcePixmap(const QPixmap &pixmap);
+    void installScaledImage(int generation, const QImage &image);
     QPixmap pix;
 public slots:
     void resizeEvent(QResizeEvent *);
+
+private:
+
+    // Image the scaled images are generated from. Unlike pixmaps, images can be used outside the GUI thread.
+    QImage source_image;
+
+    // Already scaled pixmaps, most recent first.
+    QList<QPixmap> scaled_cache;
+
+    // Timer to wait for the resizing to stop before scaling the image.
+    QTimer* scale_timer;
+
+    // Generation of the scale requests. Results of older requests are only cached, not shown.
+    int scale_generation = 0;
+
+    // Generation at which the current pixmap was set.
+    int source_generation = 0;
+
+    QSize targetSize() const;
+    void updateScaledPixmap();
+    void startScaling();
 };
 
 #endif // RESIZABLE_LABEL_H
@@ -0,0 +1,68 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include "qt_subclasses_global.h"
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QRunnable>
+#include <QSettings>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVariant>
+
+// Process-wide cache of the settings of the program, so reading and writing them never blocks on the settings backend.
+//
+// Reads are cached, so each key only touches the backend once. Writes are kept in memory and coalesced: they're flushed together,
+// in the background, flush_delay milliseconds after the first one, and whatever is left gets written when the program quits.
+//
+// The store has to be first requested from the GUI thread. Anything writing the settings on its own (like the Rust side) has
+// to call reload after it, so the cache doesn't keep the old values. invalidate_theme_palette already does it.
+class SettingsStore : public QObject {
+    Q_OBJECT
+
+public:
+
+    // Time writes wait before being flushed, so the ones happening together get flushed together.
+    int flush_delay = 1000;
+
+    static SettingsStore* instance();
+
+    QVariant value(const QString &key, const QVariant &default_value = QVariant());
+    void setValue(const QString &key, const QVariant &value);
+    void reload();
+    void flush();
+    void flushNow();
+
+private:
+    explicit SettingsStore(QObject *parent = nullptr);
+    ~SettingsStore() override;
+
+    QMutex mutex;
+    QSettings settings;
+
+    // Values already read or written, and the writes not yet sent to the backend.
+    QHash<QString, QVariant> values;
+    QHash<QString, QVariant> pending;
+
+    QTimer* flush_timer;
+
+    // Pool with a single thread, so the flushes reach the backend in order.
+    QThreadPool* flush_pool;
+};
+
+// Background write of a batch of settings to the backend.
+class SettingsFlushTask : public QRunnable {
+
+public:
+    SettingsFlushTask(const QString &organization, const QString &application, const QHash<QString, QVariant> &values);
+    void run() override;
+
+private:
+    QString organization;
+    QString application;
+    QHash<QString, QVariant> values;
+};
+
+#endif // SETTINGS_STORE_H
@@ -0,0 +1,74 @@
+#ifndef TABLE_COLUMN_CACHE_H
+#define TABLE_COLUMN_CACHE_H
+
+#include "qt_subclasses_global.h"
+#include <QAbstractItemModel>
+#include <QStandardItemModel>
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+// Type of the values of a cached column. Numeric columns also get their values stored in typed arrays.
+enum class CachedColumnType {
+    Text,
+    Integer,
+    Float
+};
+
+// Flat copy of the display data of a column. All the texts of the column live in a single UTF-16 buffer,
+// with offsets[row] and offsets[row + 1] delimiting each cell.
+//
+// check_state is -1 for non-checkable cells, 0 for unchecked ones and 1 for checked ones.
+struct CachedColumn {
+    bool has_text = false;
+    bool has_folded_text = false;
+    bool has_numbers = false;
+    CachedColumnType type = CachedColumnType::Text;
+
+    QString text;
+    QVector<int> offsets;
+    QString folded_text;
+    QVector<int> folded_offsets;
+    QVector<qint8> check_state;
+    QVector<qint64> integers;
+    QVector<double> floats;
+
+    int rowCount() const { return offsets.count() - 1; }
+    QStringRef cell(int row) const { return QStringRef(&text, offsets.at(row), offsets.at(row + 1) - offsets.at(row)); }
+    QStringRef foldedCell(int row) const { return QStringRef(&folded_text, folded_offsets.at(row), folded_offsets.at(row + 1) - folded_offsets.at(row)); }
+};
+
+// Per-column cache of a table model's display data, so filters and sorts read flat memory instead of the model.
+//
+// QStandardItemModels are read straight from their items, skipping the model.
+//
+// Columns are loaded lazily, and only from the GUI thread. Once loaded, they can be read from any thread
+// until the cache is invalidated.
+class TableColumnCache {
+
+public:
+    void setModel(const QAbstractItemModel *model);
+    void invalidate();
+    void invalidateColumns(int first, int last);
+    void updateCells(int first_row, int last_row, int first_column, int last_column);
+
+    int columnCount() const { return model != nullptr ? model->columnCount() : 0; }
+    bool isLoaded(int column) const;
+    const CachedColumn &at(int column) const { return columns.at(column); }
+
+    const CachedColumn &textColumn(int column);
+    const CachedColumn &foldedColumn(int column);
+    const CachedColumn &numericColumn(int column);
+
+private:
+    const QAbstractItemModel *model = nullptr;
+    const QStandardItemModel *standard_model = nullptr;
+    QVector<CachedColumn> columns;
+
+    void ensureColumns();
+    QVariant cellData(int row, int column) const;
+    qint8 cellCheckState(int row, int column) const;
+    void updateCell(CachedColumn &cached, int row, int column);
+};
+
+#endif // TABLE_COLUMN_CACHE_H
@@ -0,0 +1,67 @@
+#ifndef TABLE_DATA_LOADER_H
+#define TABLE_DATA_LOADER_H
+
+#include "qt_subclasses_global.h"
+#include <QAbstractItemModel>
+#include <QList>
+#include <QStandardItemModel>
+#include <QString>
+
+extern "C" void load_table_data(
+    QAbstractItemModel *model = nullptr,
+    const char *buffer = nullptr,
+    qint64 buffer_size = 0,
+    int rows = 0,
+    QList<int> column_types = QList<int>(),
+    QList<int> key_columns = QList<int>(),
+    bool editable = true,
+    QString *tooltip_template = nullptr,
+    QString *sequence_text = nullptr
+);
+
+// Type of the values of a column. This is what Rust sends as the schema of the table.
+enum class TableColumnType {
+    Boolean = 0,
+    Integer = 1,
+    Integer64 = 2,
+    Float = 3,
+    Text = 4,
+    Sequence = 5
+};
+
+// Loader of an entire table from a single packed buffer, so Rust doesn't need to build the table cell by cell.
+//
+// The buffer is row-major, with the cells of each row one after another, in native endianness. The column types
+// (TableColumnType) decide how each cell is packed:
+// - Boolean: 1 byte, 0 or 1.
+// - Integer: 4 bytes (i32).
+// - Integer64: 8 bytes (i64).
+// - Float: 4 bytes (f32).
+// - Text and Sequence: 4 bytes (u32) with the length in bytes, followed by the UTF-8 text. Sequences contain their serialized data.
+//
+// It builds the same items the Rust side used to build, so the rest of the table code doesn't need to know how they were loaded.
+// The only difference is that text cells are LazyTextItems, decoding their texts from the buffer when needed.
+class TableDataLoader {
+
+public:
+    TableDataLoader(const char *buffer, qint64 buffer_size, const QList<int> &column_types);
+
+    void loadInto(QAbstractItemModel *model, int rows, const QList<int> &key_columns, bool editable, const QString &tooltip_template, const QString &sequence_text);
+
+private:
+    const char *buffer;
+    qint64 buffer_size;
+    qint64 position = 0;
+    QList<int> column_types;
+
+    // Set if the buffer ended before all the rows were read. The rest of the rows get default values.
+    bool truncated = false;
+
+    template <typename T> T read();
+    QString readText();
+    qint64 skipText();
+
+    void loadIntoStandardModel(QStandardItemModel *model, int rows, const QList<int> &key_columns, bool editable, const QString &tooltip_template, const QString &sequence_text);
+};
+
+#endif // TABLE_DATA_LOADER_H
@@ -0,0 +1,47 @@
+#ifndef TABLE_DIAGNOSTICS_H
+#define TABLE_DIAGNOSTICS_H
+
+#include "qt_subclasses_global.h"
+#include "cell_status.h"
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+extern "C" void apply_table_diagnostics(QAbstractItemModel* model = nullptr, const qint32* cells = nullptr, int count = 0, bool replace = true);
+
+// Status bits of a cell set by the diagnostics.
+const quint8 CELL_STATUS_DIAGNOSTICS = CELL_STATUS_ERROR | CELL_STATUS_WARNING | CELL_STATUS_INFO;
+
+// Record of the diagnostics painted on a table model, so new diagnostics can be applied as a delta over it.
+//
+// Only cells whose flags change get written, and the views get a single dataChanged per block of contiguous changed cells.
+// It lives as a child of the model. If the rows or columns of the model change, the record gets rebuilt from the model the next time it's used.
+class TableDiagnostics : public QObject {
+    Q_OBJECT
+
+public:
+    explicit TableDiagnostics(QAbstractItemModel* model);
+    static TableDiagnostics* forModel(QAbstractItemModel* model);
+
+    void apply(const QHash<quint64, quint8> &cells, bool replace);
+
+private:
+    QAbstractItemModel* model;
+
+    // Diagnostic bits of every cell with any of them, by cell key.
+    QHash<quint64, quint8> painted;
+    bool painted_valid = false;
+    bool applying = false;
+
+    static quint64 cellKey(int row, int column) { return (static_cast<quint64>(row) << 32) | static_cast<quint32>(column); }
+
+    void invalidate();
+    void rebuild();
+    quint8 cellFlags(int row, int column) const;
+    void setCellFlags(int row, int column, quint8 new_flags);
+    void emitChanged(QVector<quint64> &changed);
+    void sourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles);
+};
+
+#endif // TABLE_DIAGNOSTICS_H
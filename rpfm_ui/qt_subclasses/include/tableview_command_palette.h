@@ -2,14 +2,24 @@
 #define COMMAND_PALLETE_H
 
 #include "qt_subclasses_global.h"
+#include "fuzzy_matcher.h"
 #include "QTableView"
+#include <QList>
+#include <QString>
+#include <QStringList>
 
 extern "C" QTableView* new_tableview_command_palette();
+extern "C" void tableview_command_palette_set_candidates(QTableView* palette = nullptr, QStringList* candidates = nullptr);
+extern "C" void tableview_command_palette_match(QTableView* palette = nullptr, QString* query = nullptr, int limit = 0, QList<int>* results = nullptr);
 
 class QTableViewCommandPalette : public QTableView {
     Q_OBJECT
 
     public:
+
+        // Matcher of the candidates of the palette.
+        FuzzyMatcher matcher;
+
         explicit QTableViewCommandPalette();
 
         int sizeHintForRow(int row) const override;
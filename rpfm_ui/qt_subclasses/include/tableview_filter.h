@@ -2,10 +2,18 @@
 #define TABLEVIEW_FILTER_H
 
 #include "qt_subclasses_global.h"
+#include "filter_scheduler.h"
+#include "table_column_cache.h"
+#include "trigram_index.h"
 #include <QSortFilterProxyModel>
 #include <QStandardItem>
+#include <QRegularExpression>
 #include <QList>
 #include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
 
 extern "C" QSortFilterProxyModel* new_tableview_filter(QObject *parent = nullptr);
 extern "C" void trigger_tableview_filter(
@@ -16,6 +24,56 @@ extern "C" void trigger_tableview_filter(
     QList<int> show_blank_cells = QList<int>(),
     QList<int> match_groups_per_column = QList<int>()
 );
+extern "C" void set_tableview_filter_trigram_index(QSortFilterProxyModel *filter = nullptr, bool enabled = false);
+
+// What a filter expects from a checkable cell, decided from the pattern when building the plan.
+enum class FilterCheckState {
+    Any,
+    Checked,
+    Unchecked
+};
+
+// A single filter, already compiled and ready to be tested against a cell.
+struct FilterMatch {
+    int column;
+    QString pattern;
+    bool show_blank_cells;
+    bool use_regex;
+    bool is_literal;
+    bool use_literal_search;
+    QString folded_pattern;
+    FilterCheckState check_state;
+    Qt::CaseSensitivity case_sensitivity;
+    QRegularExpression regex;
+
+    bool accepts(qint8 check_state, const QStringRef &text, const QStringRef &folded_text) const;
+    bool needsFoldedText() const;
+    bool narrows(const FilterMatch &previous) const;
+};
+
+// Immutable filter plan, built once per trigger_tableview_filter call.
+//
+// Logic for groups:
+// - For a group to be valid, all matches on it must be valid (if one of them is not valid, the entire group is invalid).
+// - For a row to be valid, one of the group needs to be valid (we keep trying until we find a valid one).
+struct FilterPlan {
+    QVector<QVector<FilterMatch>> groups;
+
+    // If there are no filters or one of the groups is empty, every row passes.
+    bool accepts_all = true;
+
+    void loadColumns(TableColumnCache &cache) const;
+    bool acceptsRow(int row, const TableColumnCache &cache) const;
+    bool narrows(const FilterPlan &previous) const;
+
+    static FilterPlan build(
+        const QList<int> &columns,
+        const QStringList &patterns,
+        const QList<int> &case_sensitive,
+        const QList<int> &show_blank_cells,
+        const QList<int> &match_groups_per_column
+    );
+};
 
 class QTableViewSortFilterProxyModel : public QSortFilterProxyModel
 {
@@ -28,14 +86,62 @@ public:
     QList<int> show_blank_cells;
     QList<int> match_groups_per_column;
 
+    // Tables with at least this amount of rows are filtered in parallel, in the background. Set it to 0 to disable it.
+    int parallel_filter_min_rows = 5000;
+
+    // Scheduler of the filter passes. Owned by the proxy.
+    FilterScheduler* scheduler;
+
     explicit QTableViewSortFilterProxyModel(QObject *parent = nullptr);
     bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const;
+    void scheduleFilterPlan(const FilterPlan &new_plan);
+    void setFilterPlan(const FilterPlan &new_plan);
+    void installFilterPass(int generation, int revision, const FilterPlan &pass_plan, const QVector<quint8> &results, const QVector<int> &row_list);
+    void setSourceModel(QAbstractItemModel *source_model) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    void setTrigramIndexEnabled(bool enabled);
+    void installTrigramIndex(int column, int generation, QSharedPointer<const TrigramIndex> index);
 
 
 protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
 
 private:
+    FilterPlan plan;
+
+    // Result of the last parallel pass, one entry per source row. A byte per row instead of a bit
+    // so workers never write to the same byte. Only valid until the source model changes.
+    QVector<quint8> accepted_rows;
+    QVector<int> accepted_row_list;
+    bool accepted_rows_valid = false;
+    QList<QMetaObject::Connection> source_connections;
+
+    // Revision of the source model's data. Passes that finish after it changed are outdated, and have to be run again.
+    int source_revision = 0;
+
+    // Flat copy of the source model's display data, shared by the filter and the sorting.
+    mutable TableColumnCache cache;
+
+    // Rank of each source row within the last sorted column.
+    QVector<int> sort_ranks;
+    int sort_ranks_column = -1;
+    Qt::CaseSensitivity sort_ranks_case_sensitivity = Qt::CaseSensitivity::CaseSensitive;
+
+    // Trigram indexes of the columns filtered by literals, built in the background. Results from an older generation are discarded.
+    bool use_trigram_index = false;
+    QHash<int, QSharedPointer<const TrigramIndex>> trigram_indexes;
+    QSet<int> trigram_indexes_building;
+    int trigram_generation = 0;
+
+    void invalidateAcceptedRows();
+    void sourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles);
+    void sourceStructureChanged();
+    void buildSortRanks(int column);
+    void invalidateSortRanks();
+    bool hasSortRanks(const QModelIndex &left, const QModelIndex &right) const;
+    void invalidateTrigramIndexes();
+    void requestTrigramIndex(int column);
+    bool trigramCandidates(const FilterPlan &filter_plan, QVector<int> &candidates);
 
 signals:
 
@@ -6,7 +6,18 @@
 
 extern "C" QTableView* new_tableview_frozen(QWidget* parent = nullptr);
 extern "C" void toggle_freezer(QTableView* tableView = nullptr, int column = 0);
+extern "C" void set_uniform_row_height(QTableView* tableView = nullptr, int height = 0);
+extern "C" void share_frozen_delegates(QTableView* tableView = nullptr);
 
+// QTableView able to freeze columns, keeping them visible on the left while scrolling horizontally.
+//
+// The frozen columns are shown by an overlay QTableView (tableViewFrozen) placed over the viewport. It exists from the start, so it can be
+// configured from Rust, but it doesn't get a model until the first column is frozen. Until then, it doesn't lay out or paint anything.
+// Once it has one, it only shows the frozen columns, and takes the scroll and the row heights from this view instead of computing its own.
+//
+// It's only a presentation of this view: it uses the same proxy, selection and delegates, it doesn't sort by itself (clicks on its header
+// sort this view, and it mirrors its sort indicator), and once the last column gets unfrozen it drops the model, so it doesn't do any
+// work while hidden. Freezing a column again sets it up from scratch.
 class QTableViewFrozen : public QTableView {
      Q_OBJECT
 
@@ -15,23 +26,39 @@ public:
     ~QTableViewFrozen() override;
 
     void setDataModel(QAbstractItemModel * model);
+    void setUniformRowHeight(int height);
+    int sizeHintForRow(int row) const override;
     QTableView *tableViewFrozen;
 
 protected:
-    //void resizeEvent(QResizeEvent *event) override;
-    //QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
-    //void scrollTo (const QModelIndex & index, ScrollHint hint = EnsureVisible) override;
+    void resizeEvent(QResizeEvent *event) override;
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    void scrollTo (const QModelIndex & index, ScrollHint hint = EnsureVisible) override;
 
 private:
     QList<int> frozenColumns;
+    bool frozen_view_initialized = false;
+
+    // Height of all the rows, if the view is in uniform row height mode. 0 if it isn't.
+    int uniform_row_height = 0;
+
     void init();
-    //void updateFrozenTableGeometry();
+    void initFrozenView();
+    void updateFrozenTableGeometry();
+    int frozenWidth() const;
+    void applyUniformRowHeight(QTableView* view);
+    void releaseFrozenView();
 
 public slots:
     void toggleFreezer(int column = 0);
+    void shareDelegates();
 
 private slots:
-    //void updateSectionWidth(int logicalIndex, int oldSize, int newSize);
-    //void updateSectionHeight(int logicalIndex, int oldSize, int newSize);
+    void updateSectionWidth(int logicalIndex, int oldSize, int newSize);
+    void updateSectionHeight(int logicalIndex, int oldSize, int newSize);
+    void updateSectionPosition(int logicalIndex, int oldVisualIndex, int newVisualIndex);
+    void updateSectionCount(int oldCount, int newCount);
+    void updateSortIndicator(int logicalIndex, Qt::SortOrder order);
+    void sortFromFrozenHeader(int logicalIndex);
 };
 #endif // TABLEVIEW_FROZEN_H
@@ -11,6 +11,10 @@
 #include <KTextEditor/Editor>
 #include <KTextEditor/View>
 #endif
+#include <QByteArray>
+#include <functional>
+#include <QObject>
+#include <QTimer>
 #include <QWidget>
 
 extern "C" QWidget* new_text_editor(QWidget* parent = nullptr);
@@ -19,6 +23,70 @@ extern "C" QString* get_text(QWidget* parent = nullptr);
 
 extern "C" void set_text(QWidget* view = nullptr, QString* text = nullptr, QString* highlighting_mode = nullptr);
 
+extern "C" void set_text_utf8(QWidget* view = nullptr, const char* text = nullptr, qint64 length = 0, QString* highlighting_mode = nullptr);
+
+extern "C" void get_text_utf8(QWidget* view = nullptr, QByteArray* buffer = nullptr);
+
+extern "C" bool get_modified_text(QWidget* view = nullptr, int* first_line = nullptr, int* original_last_line = nullptr, QString* text = nullptr);
+
+extern "C" void reset_modified_text(QWidget* view = nullptr);
+
+extern "C" void set_text_editor_large_file_read_only(QWidget* view = nullptr, bool read_only = false);
+
+// Tracker of the lines of a document changed since the last reset, as a single span of lines.
+//
+// Lines before the span are the same as in the text the tracker was reset with, and lines after it are the same but shifted, so only the span
+// needs to be read back to rebuild the text. The span is kept in current line numbers, and mapped back to the original ones using the line count.
+class TextEditorChangeTracker : public QObject {
+
+public:
+    explicit TextEditorChangeTracker(KTextEditor::Document* document);
+
+    void reset();
+    bool modifiedSpan(int &first_line, int &last_line, int &original_last_line) const;
+
+private:
+    KTextEditor::Document* document;
+    int baseline_lines = 1;
+    bool modified = false;
+    int span_first = 0;
+    int span_last = 0;
+
+    void markChanged(int first_line, int last_line, int pivot_line, int delta);
+};
+
 extern "C" void open_text_editor_config(QWidget* parent);
 
+// Loader of the text of a document.
+//
+// Small texts are set at once. Big ones are set in chunks from the event loop, so the view can paint the first lines while the rest loads,
+// with the document read-only until it's done. Their highlighting is only enabled once the load is done and the view has been idle for a bit,
+// and only if they're not too big for it. Documents in large file read-only mode keep big texts read-only and without highlighting.
+class TextEditorLoader : public QObject {
+
+public:
+    explicit TextEditorLoader(KTextEditor::Document* document);
+
+    // If big texts should stay read-only and without highlighting.
+    bool large_file_read_only = false;
+
+    void load(const QString &text, const QString &highlighting_mode);
+    void finish();
+
+private:
+    KTextEditor::Document* document;
+    QTimer* chunk_timer;
+    QTimer* highlight_timer;
+
+    QString pending_text;
+    int position = 0;
+    bool loading = false;
+    bool was_read_write = true;
+    QString highlighting_mode;
+
+    void loadNextChunk();
+    void endLoad();
+    void editWritable(const std::function<void()> &edit);
+};
+
 #endif // TEXT_EDITOR_H
@@ -0,0 +1,41 @@
+#ifndef THEME_PALETTE_H
+#define THEME_PALETTE_H
+
+#include "qt_subclasses_global.h"
+#include <QBrush>
+#include <QColor>
+#include <QPen>
+#include <QSharedPointer>
+
+extern "C" void invalidate_theme_palette();
+
+// Colours, pens and brushes the delegates use to mark the cells of a table, for one theme.
+//
+// They're loaded from the settings once per process and shared by all the delegates. Anything changing the colours in the settings
+// has to call invalidate_theme_palette, so the delegates reload them on their next paint.
+class ThemePalette {
+
+public:
+    QColor colour_table_added;
+    QColor colour_table_modified;
+    QColor colour_diagnostic_error;
+    QColor colour_diagnostic_warning;
+    QColor colour_diagnostic_info;
+
+    QBrush key_brush;
+    QPen key_pen;
+    QPen added_pen;
+    QPen modified_pen;
+    QPen error_pen;
+    QPen warning_pen;
+    QPen info_pen;
+
+    static QSharedPointer<const ThemePalette> get(bool dark_theme);
+    static int generation();
+    static void invalidate();
+
+private:
+    static QSharedPointer<const ThemePalette> load(bool dark_theme);
+};
+
+#endif // THEME_PALETTE_H
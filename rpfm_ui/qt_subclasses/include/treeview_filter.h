@@ -2,11 +2,41 @@
 #define TREEVIEW_FILTER_H
 
 #include "qt_subclasses_global.h"
+#include "filter_scheduler.h"
 #include <QSortFilterProxyModel>
 #include <QStandardItem>
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+
+// Flags accepted by trigger_treeview_filter_pattern.
+const int TREEVIEW_FILTER_CASE_SENSITIVE = 1;
 
 extern "C" QSortFilterProxyModel* new_treeview_filter(QObject *parent = nullptr);
-extern "C" void trigger_treeview_filter(QSortFilterProxyModel *filter = nullptr, QRegExp* pattern = nullptr);
+extern "C" void trigger_treeview_filter_pattern(QSortFilterProxyModel *filter = nullptr, QString* pattern = nullptr, int flags = 0);
+
+// How a tree filter gets matched against a path, decided once when the pattern is compiled.
+enum class TreeFilterMatchKind {
+    All,
+    Contains,
+    Prefix,
+    Suffix,
+    Exact,
+    Regex
+};
+
+// A tree filter pattern, compiled once per trigger. Patterns without metacharacters (other than a leading ^ or a trailing $)
+// skip the regex engine entirely.
+struct TreeFilterMatcher {
+    TreeFilterMatchKind kind = TreeFilterMatchKind::All;
+    QString literal;
+    Qt::CaseSensitivity case_sensitivity = Qt::CaseSensitivity::CaseSensitive;
+    QRegularExpression regex;
+
+    bool matches(const QString &text) const;
+
+    static TreeFilterMatcher compile(const QString &pattern, Qt::CaseSensitivity case_sensitivity);
+};
 
 class QTreeViewSortFilterProxyModel : public QSortFilterProxyModel
 {
@@ -14,12 +44,34 @@ class QTreeViewSortFilterProxyModel : public QSortFilterProxyModel
 
 public:
 
+    // Scheduler of the filter passes. Owned by the proxy.
+    FilterScheduler* scheduler;
+
     explicit QTreeViewSortFilterProxyModel(QObject *parent = nullptr);
     bool filterAcceptsRow(int source_row, const QModelIndex & source_parent) const;
+    void setSourceModel(QAbstractItemModel *source_model) override;
+    void invalidateMatchCache();
+    void scheduleFilterPattern(const QString &pattern, Qt::CaseSensitivity case_sensitivity);
+    void setFilterPattern(const QString &pattern, Qt::CaseSensitivity case_sensitivity);
 
 signals:
 
 private:
+
+    TreeFilterMatcher matcher;
+
+    // Bits of the match state of a node.
+    static const quint8 NODE_MATCHES = 1;
+    static const quint8 NODE_VISIBLE = 2;
+
+    // Match state of every node evaluated since the last filter change. Only valid until the source model changes.
+    mutable QHash<QModelIndex, quint8> match_cache;
+    QList<QMetaObject::Connection> source_connections;
+
+    quint8 nodeState(int source_row, const QModelIndex &source_parent) const;
+    bool nodeMatches(const QModelIndex &source_index) const;
+    bool rowMatches(int source_row, const QModelIndex &source_parent) const;
+    void sourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles);
 };
 
 #endif // TREEVIEW_FILTER_H
@@ -0,0 +1,33 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include "qt_subclasses_global.h"
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// Trigram index over the case-folded texts of a table column.
+//
+// For each sequence of 3 UTF-16 characters, it keeps the sorted list of rows containing it. Any row containing
+// a literal contains all its trigrams, so intersecting their lists gives the only rows that can match it.
+class TrigramIndex {
+
+public:
+    static TrigramIndex build(const QString &text, const QVector<int> &offsets);
+
+    bool canSearch(const QString &folded_literal) const { return folded_literal.count() >= 3; }
+    QVector<int> candidates(const QString &folded_literal) const;
+
+    // Rows with empty cells. They never contain a literal, but can still pass filters that show blank cells.
+    const QVector<int> &blankRows() const { return blank_rows; }
+
+private:
+    QHash<quint64, QVector<int>> postings;
+    QVector<int> blank_rows;
+
+    static quint64 trigram(const QChar *characters) {
+        return (quint64(characters[0].unicode()) << 32) | (quint64(characters[1].unicode()) << 16) | quint64(characters[2].unicode());
+    }
+};
+
+#endif // TRIGRAM_INDEX_H
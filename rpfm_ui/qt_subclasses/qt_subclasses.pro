@@ -29,25 +29,45 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs depr
 
 SOURCES += \
     src/extended_q_styled_item_delegate.cpp \
+    src/filter_scheduler.cpp \
+    src/fuzzy_matcher.cpp \
+    src/instrumentation.cpp \
     src/q_main_window_custom.cpp \
+    src/lazy_text_item.cpp \
+    src/literal_matcher.cpp \
     src/packed_file_model.cpp \
+    src/parallel_for.cpp \
     src/qstring_item_delegate.cpp \
+    src/reference_list_registry.cpp \
     src/combobox_item_delegate.cpp \
     src/resizable_label.cpp \
+    src/settings_store.cpp \
     src/spinbox_item_delegate.cpp \
+    src/table_column_cache.cpp \
+    src/table_data_loader.cpp \
+    src/table_diagnostics.cpp \
     src/doublespinbox_item_delegate.cpp \
     src/tableview_command_palette.cpp \
     src/tableview_filter.cpp \
     src/tableview_frozen.cpp \
     src/text_editor.cpp \
-    src/treeview_filter.cpp
+    src/theme_palette.cpp \
+    src/treeview_filter.cpp \
+    src/trigram_index.cpp
 
 INCLUDEPATH += include
 INCLUDEPATH += C:\CraftRoot\include
 
 HEADERS += \
+    include/cell_status.h \
     include/extended_q_styled_item_delegate.h \
+    include/filter_scheduler.h \
+    include/fuzzy_matcher.h \
+    include/instrumentation.h \
     include/qt_subclasses_global.h \
+    include/table_column_cache.h \
+    include/table_data_loader.h \
+    include/table_diagnostics.h \
     include/tableview_command_palette.h \
     include/tableview_filter.h \
     include/tableview_frozen.h \
@@ -55,10 +75,17 @@ HEADERS += \
     include/spinbox_item_delegate.h \
     include/doublespinbox_item_delegate.h \
     include/text_editor.h \
+    include/theme_palette.h \
     include/treeview_filter.h \
+    include/trigram_index.h \
     include/qstring_item_delegate.h \
+    include/reference_list_registry.h \
+    include/lazy_text_item.h \
+    include/literal_matcher.h \
     include/packed_file_model.h \
+    include/parallel_for.h \
     include/resizable_label.h \
+    include/settings_store.h \
     include/q_main_window_custom.h
 
 release:DESTDIR = release
@@ -0,0 +1,41 @@
+#-------------------------------------------------
+#
+# Benchmarks of the hot paths of qt_subclasses: table filtering and sorting, tree filtering and delegate painting.
+#
+# Build qt_subclasses.pro first, as this links against the static lib it leaves in libs. Then build this one with
+# "qmake qt_subclasses_benchmarks.pro && make -f Makefile.benchmarks", and run it with --help to see the options.
+# Results are written as JSON, so they can be compared between releases.
+#
+#-------------------------------------------------
+
+QT       += widgets
+QT       += KTextEditor
+
+TARGET = qt_subclasses_benchmarks
+TEMPLATE = app
+
+CONFIG += console release
+CONFIG -= app_bundle
+
+# Its own makefile, so it doesn't overwrite the one of the lib, which lives in the same folder.
+MAKEFILE = Makefile.benchmarks
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+SOURCES += \
+    benchmarks/benchmarks.cpp
+
+INCLUDEPATH += include
+INCLUDEPATH += C:\CraftRoot\include
+
+LIBS += -L$$PWD/../../libs -lqt_subclasses
+
+# This means we generate all the artifacts in target, and the benchmarks next to the lib.
+DESTDIR         = ../../libs
+BASEDIR         = ../../target/qt_subclasses_benchmarks
+MOC_DIR         = ../../target/qt_subclasses_benchmarks/moc
+OBJECTS_DIR     = ../../target/qt_subclasses_benchmarks/obj
+
+# Fix for make failing due to missing folders.
+commands = ; $(MKDIR -p) BASEDIR; $(MKDIR -p) $MOC_DIR; $(MKDIR -p) $OBJECTS_DIR
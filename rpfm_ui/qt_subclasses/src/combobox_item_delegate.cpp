@@ -1,7 +1,7 @@
 #include "combobox_item_delegate.h"
+#include "instrumentation.h"
 #include <QDebug>
 #include <QAbstractItemView>
-#include <QSettings>
 
 // Function to be called from any other language. This assing to the provided column of the provided TableView a QComboBoxItemDelegate,
 // with the specified values. We have to tell it too if the combo will be editable or not.
@@ -10,45 +10,61 @@ extern "C" void new_combobox_item_delegate(QObject *parent, const int column, co
     dynamic_cast<QAbstractItemView*>(parent)->setItemDelegateForColumn(column, delegate);
 }
 
+// Function to be called from any other language. Like new_combobox_item_delegate, but the values come from a list of the ReferenceListRegistry,
+// so they're shared with any other delegate using the same list, and follow its updates.
+extern "C" void new_combobox_item_delegate_shared(QObject *parent, const int column, const int reference_list, const bool is_editable, const int max_lenght, QTimer* timer, bool is_dark_theme_enabled, bool has_filter, bool right_side_mark) {
+    QComboBoxItemDelegate* delegate = new QComboBoxItemDelegate(parent, QStringList(), is_editable, max_lenght, timer, is_dark_theme_enabled, has_filter, right_side_mark);
+    delegate->useReferenceList(reference_list);
+    dynamic_cast<QAbstractItemView*>(parent)->setItemDelegateForColumn(column, delegate);
+}
+
 // Constructor of the QComboBoxItemDelegate. We use it to store the values and if the user should be able to write his own value.
 QComboBoxItemDelegate::QComboBoxItemDelegate(QObject *parent, const QStringList provided_values, bool is_editable, int lenght, QTimer* timer, bool is_dark_theme_enabled, bool has_filter, bool right_side_mark): QExtendedStyledItemDelegate(parent, timer, is_dark_theme_enabled, has_filter, right_side_mark)
 {
     editable = is_editable;
-    values = provided_values;
+    values_model = new QStringListModel(provided_values, this);
+    completer = new QCompleter(values_model, this);
+
+    // Same completion the combos do by default: case insensitive and inline.
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setCompletionMode(QCompleter::InlineCompletion);
     max_lenght = lenght;
     diag_timer = timer;
     dark_theme = is_dark_theme_enabled;
     use_filter = has_filter;
     use_right_side_mark = right_side_mark;
+    pool_editors = true;
+}
 
-    QSettings* q_settings = new QSettings("FrodoWazEre", "rpfm");
-
-    if (dark_theme) {
-        colour_table_added = QColor(q_settings->value("colour_dark_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_dark_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_dark_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_dark_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_dark_diagnostic_info").toString());
-    } else {
-        colour_table_added = QColor(q_settings->value("colour_light_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_light_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_light_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_light_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_light_diagnostic_info").toString());
+// Destructor of the QComboBoxItemDelegate. The reference list is released, so it gets dropped once no delegate uses it.
+QComboBoxItemDelegate::~QComboBoxItemDelegate() {
+    if (reference_list >= 0) {
+        ReferenceListRegistry::release(reference_list);
     }
 }
 
 // Function called when the combo it's created. It just put the values into the combo and returns it.
 QWidget* QComboBoxItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &, const QModelIndex &) const {
+    InstrumentationScope scope(InstrumentationProbe::DelegateCreateEditor);
 
     // Stop the diagnostics timer, so it doesn't steal the focus of the editor.
     if (diag_timer) {
         diag_timer->stop();
     }
 
+    // Editors of this delegate are all the same, so we reuse them if we can.
+    if (QWidget* editor = takePooledEditor(parent)) {
+        return editor;
+    }
+
+    // The values are not copied into the combo. It just uses the model of the delegate.
     QComboBox* comboBox = new QComboBox(parent);
     comboBox->setEditable(editable);
-    comboBox->addItems(values);
+    comboBox->setModel(values_model);
+    if (editable) {
+        comboBox->setCompleter(completer);
+    }
+
     if (this->max_lenght > 0) {
         //comboBox->setMaxLength(max_lenght);
     }
@@ -62,12 +78,64 @@ void QComboBoxItemDelegate::setEditorData(QWidget *editor, const QModelIndex &in
 
     // If no item has been found with that text, we add it and select it.
     // This fixes the "the text vanished when I double clicked the cell" bug.
+    //
+    // As the model is shared, the value is only added until the editor is closed. Editable combos don't need it, they can just show it as text.
     int pos = comboBox->findText(value);
     if (pos != -1) { comboBox->setCurrentIndex(pos); }
+    else if (editable) {
+        comboBox->setCurrentIndex(-1);
+        comboBox->setEditText(value);
+    }
     else {
-        comboBox->insertItem(0, value);
+        values_model->insertRows(0, 1);
+        values_model->setData(values_model->index(0), value);
         comboBox->setCurrentIndex(0);
+        comboBox->setProperty("inserted_value", true);
+        inserted_rows++;
+    }
+}
+
+// Function called when the view is done with the combo. If we added the value of the cell to the values, we remove it here.
+void QComboBoxItemDelegate::destroyEditor(QWidget *editor, const QModelIndex &index) const {
+    if (editor != nullptr && editor->property("inserted_value").toBool()) {
+        editor->setProperty("inserted_value", false);
+        values_model->removeRows(0, 1);
+        inserted_rows--;
+
+        if (inserted_rows == 0 && reference_list_outdated) {
+            reloadReferenceList();
+        }
+    }
+
+    QExtendedStyledItemDelegate::destroyEditor(editor, index);
+}
+
+// Function to make the delegate show a list of the ReferenceListRegistry, and keep it updated when a new version of it gets registered.
+void QComboBoxItemDelegate::useReferenceList(int handle) {
+    if (handle < 0) {
+        return;
     }
+
+    reference_list = handle;
+    ReferenceListRegistry::instance()->acquire(handle);
+    connect(ReferenceListRegistry::instance(), &ReferenceListRegistry::listChanged, this, [this](int changed_handle) {
+        if (changed_handle == reference_list) {
+            reloadReferenceList();
+        }
+    });
+
+    reloadReferenceList();
+}
+
+// Function to take the current version of the reference list. It's only a shallow copy, the strings are shared with the registry.
+void QComboBoxItemDelegate::reloadReferenceList() const {
+    if (inserted_rows > 0) {
+        reference_list_outdated = true;
+        return;
+    }
+
+    reference_list_outdated = false;
+    values_model->setStringList(ReferenceListRegistry::instance()->values(reference_list));
 }
 
 // Function to be called when we're done. It just takes the selected value and saves it in the Table Model.
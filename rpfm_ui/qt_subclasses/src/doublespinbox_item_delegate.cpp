@@ -1,9 +1,9 @@
 #include "doublespinbox_item_delegate.h"
+#include "instrumentation.h"
 #include "float.h"
 #include <QDebug>
 #include <QAbstractItemView>
 #include <QDoubleSpinBox>
-#include <QSettings>
 
 // Function to be called from any other language. This assing to the provided column of the provided TableView a QDoubleSpinBoxItemDelegate.
 extern "C" void new_doublespinbox_item_delegate(QObject *parent, const int column, QTimer* timer, bool is_dark_theme_enabled, bool has_filter, bool right_side_mark) {
@@ -17,32 +17,23 @@ QDoubleSpinBoxItemDelegate::QDoubleSpinBoxItemDelegate(QObject *parent, QTimer*
     dark_theme = is_dark_theme_enabled;
     use_filter = has_filter;
     use_right_side_mark = right_side_mark;
-
-    QSettings* q_settings = new QSettings("FrodoWazEre", "rpfm");
-
-    if (dark_theme) {
-        colour_table_added = QColor(q_settings->value("colour_dark_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_dark_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_dark_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_dark_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_dark_diagnostic_info").toString());
-    } else {
-        colour_table_added = QColor(q_settings->value("colour_light_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_light_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_light_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_light_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_light_diagnostic_info").toString());
-    }
+    pool_editors = true;
 }
 
 // Function called when the spinbox it's created. Here we configure the limits and decimals of the spinbox.
 QWidget* QDoubleSpinBoxItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &, const QModelIndex &) const {
+    InstrumentationScope scope(InstrumentationProbe::DelegateCreateEditor);
 
     // Stop the diagnostics timer, so it doesn't steal the focus of the editor.
     if (diag_timer) {
         diag_timer->stop();
     }
 
+    // Editors of this delegate are all the same, so we reuse them if we can.
+    if (QWidget* editor = takePooledEditor(parent)) {
+        return editor;
+    }
+
     QDoubleSpinBox* spinBox = new QDoubleSpinBox(parent);
     spinBox->setRange(-3.402823e+38, 3.402823e+38);
     spinBox->setDecimals(3);
@@ -1,4 +1,5 @@
 #include "extended_q_styled_item_delegate.h"
+#include "instrumentation.h"
 #include <QDebug>
 #include <QAbstractItemView>
 #include <QSortFilterProxyModel>
@@ -7,7 +8,6 @@
 #include <QPainter>
 #include <QStandardItem>
 #include <QStyle>
-#include <QSettings>
 
 // Function to be called from any other language. This assing to the provided column of the provided TableView a QExtendedStyledItemDelegate.
 extern "C" void new_generic_item_delegate(QObject *parent, const int column, QTimer* timer, bool is_dark_theme_enabled, bool has_filter, bool right_side_mark) {
@@ -22,26 +22,60 @@ QExtendedStyledItemDelegate::QExtendedStyledItemDelegate(QObject *parent, QTimer
     dark_theme = is_dark_theme_enabled;
     use_filter = has_filter;
     use_right_side_mark = right_side_mark;
+}
 
-    QSettings* q_settings = new QSettings("FrodoWazEre", "rpfm");
+// Destructor of QExtendedStyledItemDelegate. Pooled editors are not in use by the view, so we get rid of them.
+QExtendedStyledItemDelegate::~QExtendedStyledItemDelegate() {
+    for (const QPointer<QWidget> &editor: editor_pool) {
+        if (!editor.isNull()) {
+            editor->deleteLater();
+        }
+    }
+}
 
-    if (dark_theme) {
-        colour_table_added = QColor(q_settings->value("colour_dark_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_dark_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_dark_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_dark_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_dark_diagnostic_info").toString());
-    } else {
-        colour_table_added = QColor(q_settings->value("colour_light_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_light_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_light_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_light_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_light_diagnostic_info").toString());
+// Function to get an editor from the pool, if there is one for the provided parent. Editors of other parents are discarded.
+QWidget* QExtendedStyledItemDelegate::takePooledEditor(QWidget *parent) const {
+    while (!editor_pool.isEmpty()) {
+        QPointer<QWidget> editor = editor_pool.takeLast();
+        if (editor.isNull()) {
+            continue;
+        }
+
+        if (editor->parentWidget() == parent) {
+            return editor.data();
+        }
+
+        editor->deleteLater();
+    }
+
+    return nullptr;
+}
+
+// Function called when the view is done with an editor. If pooling is enabled, the editor is kept for the next edition.
+//
+// The view connects to the destroyed signal of every editor it opens, so we drop that connection here to not pile up a new one on each reuse.
+// Only the connections to the view owning the editor are dropped. Anything else connected to the editor keeps its connections.
+void QExtendedStyledItemDelegate::destroyEditor(QWidget *editor, const QModelIndex &index) const {
+    const int max_pooled_editors = 2;
+    if (pool_editors && editor != nullptr && editor_pool.count() < max_pooled_editors) {
+        for (QObject *ancestor = editor->parent(); ancestor != nullptr; ancestor = ancestor->parent()) {
+            if (QAbstractItemView *view = qobject_cast<QAbstractItemView*>(ancestor)) {
+                disconnect(editor, &QObject::destroyed, view, nullptr);
+                break;
+            }
+        }
+
+        editor->hide();
+        editor_pool.append(QPointer<QWidget>(editor));
+        return;
     }
+
+    QStyledItemDelegate::destroyEditor(editor, index);
 }
 
 // Function called when the editor for the cell it's created.
 QWidget* QExtendedStyledItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    InstrumentationScope scope(InstrumentationProbe::DelegateCreateEditor);
 
     // Stop the diagnostics timer, so it doesn't steal the focus of the editor.
     if (diag_timer) {
@@ -51,146 +85,75 @@ QWidget* QExtendedStyledItemDelegate::createEditor(QWidget *parent, const QStyle
     return QStyledItemDelegate::createEditor(parent, option, index);
 }
 
+// Function to get the palette of the current theme. It's only fetched again if it has been invalidated since the last time.
+const ThemePalette &QExtendedStyledItemDelegate::themePalette() const {
+    int current_generation = ThemePalette::generation();
+    if (palette.isNull() || palette_generation != current_generation) {
+        palette = ThemePalette::get(dark_theme);
+        palette_generation = current_generation;
+    }
+
+    return *palette;
+}
+
+// Function to draw one of the marks on the side of a cell, with the pen of its status.
+void QExtendedStyledItemDelegate::drawMark(QPainter *painter, const QStyleOptionViewItem &option, const QPen &pen) const {
+    int lineWidth = pen.width();
+    painter->setPen(pen);
+    if (use_right_side_mark) {
+        painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
+    } else {
+        painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
+    }
+}
+
 // Function for the delegate to showup properly.
 void QExtendedStyledItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    InstrumentationScope scope(InstrumentationProbe::DelegatePaint);
     QStyledItemDelegate::paint( painter, option, index );
 
-    if (use_filter && index.isValid()) {
-        const QSortFilterProxyModel* filterModel = dynamic_cast<const QSortFilterProxyModel*>(index.model());
-        const QStandardItemModel* standardModel = dynamic_cast<const QStandardItemModel*>(filterModel->sourceModel());
-        QStandardItem* item = standardModel->itemFromIndex(filterModel->mapToSource(index));
-
-        if (item != nullptr) {
-            QVariant isKeyVariant = item->data(20);
-            QVariant isAddedVariant = item->data(21);
-            QVariant isModifiedVariant = item->data(22);
-            QVariant isErrorVariant = item->data(25);
-            QVariant isWarningVariant = item->data(26);
-            QVariant isInfoVariant = item->data(27);
-
-            bool isKey = !isKeyVariant.isNull() ? isKeyVariant.toBool(): false;
-            bool isAdded = !isAddedVariant.isNull() ? isAddedVariant.toBool(): false;
-            bool isModified = !isModifiedVariant.isNull() ? isModifiedVariant.toBool(): false;
-
-            bool isError = !isErrorVariant.isNull() ? isErrorVariant.toBool(): false;
-            bool isWarning = !isWarningVariant.isNull() ? isWarningVariant.toBool(): false;
-            bool isInfo = !isInfoVariant.isNull() ? isInfoVariant.toBool(): false;
-
-            // Fun fact about the painter. It's the same it was used in the cell before,
-            // with the same config as the cell before.
-            //
-            // This means if the cell before was a key, this one will have the key background.
-            // This and the restore at the end fixes it.
-            painter->save();
-
-            // Paint the background of keys, to identify them.
-            if (isKey) {
-                QColor colorBrush;
-
-                if (dark_theme) {
-                    colorBrush.setRgbF(82, 82, 0, 0.1);
-                } else {
-                    colorBrush.setRgbF(255, 255, 0, 0.1);
-                }
-
-                QBrush qBrush(colorBrush);
-                qBrush.setStyle(Qt::BrushStyle::SolidPattern);
-
-                auto pen = QPen();
-                pen.setWidth(0);
-                pen.setColor(colorBrush);
-
-                painter->setBrush(qBrush);
-                painter->setPen(pen);
-                painter->drawRect(option.rect);
-            }
-
-            // Modified takes priority over added.
-            if (isModified) {
-                auto pen = QPen();
-                pen.setColor(colour_table_modified);
-
-                int lineWidth = 2;
-                pen.setStyle(Qt::PenStyle::SolidLine);
-                pen.setWidth(lineWidth);
-
-                painter->setPen(pen);
-                if (use_right_side_mark) {
-                    painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                } else {
-                    painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                }
-            }
-
-            else if (!isModified && isAdded) {
-                auto pen = QPen();
-                pen.setColor(colour_table_added);
+    if (!use_filter || !index.isValid()) {
+        return;
+    }
 
-                int lineWidth = 2;
-                pen.setStyle(Qt::PenStyle::SolidLine);
-                pen.setWidth(lineWidth);
+    // Most cells have nothing to mark, so they don't even touch the painter.
+    const quint8 status = cell_status(index);
+    if (status == 0) {
+        return;
+    }
 
-                painter->setPen(pen);
-                if (use_right_side_mark) {
-                    painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                } else {
-                    painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                }
-            }
+    // Fun fact about the painter. It's the same it was used in the cell before,
+    // with the same config as the cell before.
+    //
+    // This means if the cell before was a key, this one will have the key background.
+    // This and the restore at the end fixes it.
+    painter->save();
 
-            // By priority, info goes first.
-            if (isInfo) {
-                auto pen = QPen();
-                pen.setColor(colour_diagnostic_info);
-
-                int lineWidth = 4;
-                pen.setStyle(Qt::PenStyle::SolidLine);
-                pen.setWidth(lineWidth);
-
-                painter->setPen(pen);
-                if (use_right_side_mark) {
-                    painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                } else {
-                    painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                }
-            }
+    const ThemePalette &palette = themePalette();
 
-            // Warning goes second, overwriting info.
-            if (isWarning) {
-                auto pen = QPen();
-                pen.setColor(colour_diagnostic_warning);
-
-                int lineWidth = 4;
-                pen.setStyle(Qt::PenStyle::SolidLine);
-                pen.setWidth(lineWidth);
-
-                painter->setPen(pen);
-                if (use_right_side_mark) {
-                    painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                } else {
-                    painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                }
-            }
+    // Paint the background of keys, to identify them.
+    if (status & CELL_STATUS_KEY) {
+        painter->setBrush(palette.key_brush);
+        painter->setPen(palette.key_pen);
+        painter->drawRect(option.rect);
+    }
 
-            // Error goes last, overwriting everything.
-            if (isError) {
-                auto pen = QPen();
-                pen.setColor(colour_diagnostic_error);
-
-                int lineWidth = 4;
-                pen.setStyle(Qt::PenStyle::SolidLine);
-                pen.setWidth(lineWidth);
-
-                painter->setPen(pen);
-                if (use_right_side_mark) {
-                    painter->drawLine(QLineF(option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + (lineWidth / 2), option.rect.x() + option.rect.width() - (lineWidth / 2), option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                } else {
-                    painter->drawLine(QLineF(option.rect.x() + 1, option.rect.y() + (lineWidth / 2), option.rect.x() + 1, option.rect.y() + option.rect.height() - (lineWidth / 4)));
-                }
-            }
+    // Modified takes priority over added.
+    if (status & CELL_STATUS_MODIFIED) {
+        drawMark(painter, option, palette.modified_pen);
+    } else if (status & CELL_STATUS_ADDED) {
+        drawMark(painter, option, palette.added_pen);
+    }
 
-            // Remember to restore the painter so we can reuse it for other cells.
-            painter->restore();
-        }
+    // Diagnostic marks are drawn in the same place, so only the one with the highest priority is visible: error, then warning, then info.
+    if (status & CELL_STATUS_ERROR) {
+        drawMark(painter, option, palette.error_pen);
+    } else if (status & CELL_STATUS_WARNING) {
+        drawMark(painter, option, palette.warning_pen);
+    } else if (status & CELL_STATUS_INFO) {
+        drawMark(painter, option, palette.info_pen);
     }
+
+    // Remember to restore the painter so we can reuse it for other cells.
+    painter->restore();
 }
@@ -0,0 +1,65 @@
+#include "filter_scheduler.h"
+
+// Function to set, from Rust, how long a filter waits for more changes before filtering. 0 means it filters right away.
+extern "C" void set_filter_debounce(QObject* filter, int msec) {
+    if (filter == nullptr) {
+        return;
+    }
+
+    FilterScheduler* scheduler = filter->findChild<FilterScheduler*>(QString(), Qt::FindDirectChildrenOnly);
+    if (scheduler != nullptr) {
+        scheduler->setDebounce(msec);
+    }
+}
+
+// Constructor of FilterScheduler.
+FilterScheduler::FilterScheduler(QObject* parent): QObject(parent) {
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    connect(timer, &QTimer::timeout, this, &FilterScheduler::flush);
+}
+
+// Function to change the debounce window. A pass already waiting gets its wait restarted with the new window.
+void FilterScheduler::setDebounce(int msec) {
+    debounce_msec = qMax(0, msec);
+    if (timer->isActive()) {
+        timer->start(debounce_msec);
+    }
+}
+
+// Function to request a pass. It replaces any other pass still waiting for the debounce window.
+void FilterScheduler::schedule(const std::function<void()> &pass) {
+    pending_pass = pass;
+    if (debounce_msec <= 0) {
+        flush();
+    } else {
+        timer->start(debounce_msec);
+    }
+}
+
+// Function to run the waiting pass now, if there is one.
+void FilterScheduler::flush() {
+    timer->stop();
+    if (!pending_pass) {
+        return;
+    }
+
+    std::function<void()> pass = pending_pass;
+    pending_pass = nullptr;
+    pass();
+}
+
+// Function to drop the waiting pass, and cancel the one running, if any.
+void FilterScheduler::cancel() {
+    timer->stop();
+    pending_pass = nullptr;
+    current_token.cancel();
+    current_generation++;
+}
+
+// Function to mark the beginning of a pass. Whatever pass was running before gets cancelled.
+int FilterScheduler::beginPass() {
+    current_token.cancel();
+    current_token = FilterCancelToken();
+    return ++current_generation;
+}
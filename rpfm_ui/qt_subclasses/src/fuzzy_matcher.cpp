@@ -0,0 +1,222 @@
+#include "fuzzy_matcher.h"
+#include "parallel_for.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+#include <vector>
+
+// Points of each part of a match.
+const int SCORE_MATCH = 16;
+const int BONUS_BOUNDARY = 24;
+const int BONUS_CONSECUTIVE = 16;
+const int MAX_GAP_PENALTY = 12;
+
+// Function to check if a character separates words.
+static bool isSeparator(const QChar &character) {
+    switch (character.unicode()) {
+        case '/':
+        case '\\':
+        case '_':
+        case '-':
+        case '.':
+        case ' ':
+        case ':':
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Function to compare two matches. Better scores go first, and ties keep the order of the candidates.
+static bool isBetter(const FuzzyMatch &left, const FuzzyMatch &right) {
+    return left.score > right.score || (left.score == right.score && left.index < right.index);
+}
+
+// Function to get the bag of characters of a lowercase text: one bit for each letter and digit, and the rest share the remaining bits.
+quint64 FuzzyMatcher::characterBag(const QString &lower_text) {
+    quint64 bag = 0;
+    for (const QChar &character: lower_text) {
+        ushort code = character.unicode();
+        int bit;
+        if (code >= 'a' && code <= 'z') {
+            bit = code - 'a';
+        } else if (code >= '0' && code <= '9') {
+            bit = 26 + (code - '0');
+        } else {
+            bit = 36 + (code % 28);
+        }
+
+        bag |= Q_UINT64_C(1) << bit;
+    }
+
+    return bag;
+}
+
+// Function to set the candidates, precomputing everything the queries need about them.
+//
+// Characters are lowercased one by one, so the positions in the buffer match the ones in the original texts.
+void FuzzyMatcher::setCandidates(const QStringList &candidates) {
+    int total_length = 0;
+    for (const QString &candidate: candidates) {
+        total_length += candidate.size();
+    }
+
+    text.clear();
+    text.reserve(total_length);
+    offsets.clear();
+    offsets.reserve(candidates.count() + 1);
+    offsets.append(0);
+    boundaries.fill(0, (total_length >> 6) + 1);
+    bags.clear();
+    bags.reserve(candidates.count());
+
+    for (const QString &candidate: candidates) {
+        const int begin = text.size();
+        for (int position = 0; position < candidate.size(); ++position) {
+            const QChar character = candidate.at(position);
+            const QChar previous = position > 0 ? candidate.at(position - 1) : QChar();
+            bool is_boundary = position == 0 ||
+                (isSeparator(previous) && !isSeparator(character)) ||
+                (character.isUpper() && previous.isLower());
+
+            if (is_boundary) {
+                const int buffer_position = begin + position;
+                boundaries[buffer_position >> 6] |= Q_UINT64_C(1) << (buffer_position & 63);
+            }
+
+            text.append(character.toLower());
+        }
+
+        offsets.append(text.size());
+        bags.append(characterBag(QString::fromRawData(text.constData() + begin, candidate.size())));
+    }
+}
+
+// Function to score a candidate against a lowercase query. Returns -1 if it doesn't match.
+//
+// The characters of the query have to appear in order. We look for the leftmost end of a match, then walk backwards from there
+// to find the shortest match ending there, and score that one: points for each character, more if it starts a word or follows
+// the previous one, and less for each skipped character.
+int FuzzyMatcher::score(int candidate, const QString &lower_query, quint64 query_bag) const {
+    if ((query_bag & ~bags.at(candidate)) != 0) {
+        return -1;
+    }
+
+    const int begin = offsets.at(candidate);
+    const int end = offsets.at(candidate + 1);
+    const int query_length = lower_query.size();
+    if (query_length > end - begin) {
+        return -1;
+    }
+
+    const QChar* data = text.constData();
+    const QChar* query = lower_query.constData();
+
+    int matched = 0;
+    int position = begin;
+    for (; position < end && matched < query_length; ++position) {
+        if (data[position] == query[matched]) {
+            matched++;
+        }
+    }
+
+    if (matched < query_length) {
+        return -1;
+    }
+
+    const int match_end = position;
+    int match_begin = match_end - 1;
+    for (int remaining = query_length - 1; match_begin >= begin; --match_begin) {
+        if (data[match_begin] == query[remaining] && --remaining < 0) {
+            break;
+        }
+    }
+
+    int score = 0;
+    int last = -1;
+    matched = 0;
+    for (position = match_begin; position < match_end && matched < query_length; ++position) {
+        if (data[position] != query[matched]) {
+            continue;
+        }
+
+        score += SCORE_MATCH;
+        if (isBoundary(position)) {
+            score += BONUS_BOUNDARY;
+        }
+
+        if (last != -1) {
+            score += position == last + 1 ? BONUS_CONSECUTIVE : -qMin(position - last - 1, MAX_GAP_PENALTY);
+        }
+
+        last = position;
+        matched++;
+    }
+
+    // Between equal matches, shorter candidates are closer to what the user typed.
+    return score * 4 - qMin(end - begin, 256) / 16;
+}
+
+// Function to get the best candidates for a query, best first. An empty query gets the first candidates, in order.
+QVector<FuzzyMatch> FuzzyMatcher::match(const QString &query, int limit) const {
+    QVector<FuzzyMatch> results;
+    if (limit <= 0) {
+        return results;
+    }
+
+    QString lower_query;
+    lower_query.reserve(query.size());
+    for (const QChar &character: query) {
+        if (character != QLatin1Char(' ')) {
+            lower_query.append(character.toLower());
+        }
+    }
+
+    if (lower_query.isEmpty()) {
+        for (int index = 0; index < qMin(limit, count()); ++index) {
+            results.append({index, 0});
+        }
+        return results;
+    }
+
+    const quint64 query_bag = characterBag(lower_query);
+    std::vector<FuzzyMatch> best;
+    QMutex best_mutex;
+
+    // Each chunk keeps its best results in a heap with the worst of them on top, so it's easy to know what to replace.
+    parallel_for(count(), 4096, [&](int chunk_begin, int chunk_end) {
+        std::vector<FuzzyMatch> heap;
+        heap.reserve(limit);
+        for (int index = chunk_begin; index < chunk_end; ++index) {
+            int candidate_score = score(index, lower_query, query_bag);
+            if (candidate_score < 0) {
+                continue;
+            }
+
+            FuzzyMatch candidate_match = {index, candidate_score};
+            if (static_cast<int>(heap.size()) < limit) {
+                heap.push_back(candidate_match);
+                std::push_heap(heap.begin(), heap.end(), isBetter);
+            } else if (isBetter(candidate_match, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), isBetter);
+                heap.back() = candidate_match;
+                std::push_heap(heap.begin(), heap.end(), isBetter);
+            }
+        }
+
+        QMutexLocker locker(&best_mutex);
+        best.insert(best.end(), heap.begin(), heap.end());
+    });
+
+    std::sort(best.begin(), best.end(), isBetter);
+    if (static_cast<int>(best.size()) > limit) {
+        best.resize(limit);
+    }
+
+    results.reserve(static_cast<int>(best.size()));
+    for (const FuzzyMatch &result: best) {
+        results.append(result);
+    }
+
+    return results;
+}
@@ -0,0 +1,135 @@
+#include "instrumentation.h"
+#include <QAtomicInteger>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtAlgorithms>
+
+// Amount of buckets of each histogram. Bucket i holds the calls that took between 2^i and 2^(i + 1) nanoseconds, and the last one everything slower.
+const int HISTOGRAM_BUCKETS = 40;
+
+// Names of the probes, as they show up in the snapshots. Same order as InstrumentationProbe.
+static const char* const PROBE_NAMES[] = {
+    "table_filter_accepts_row",
+    "table_less_than",
+    "table_filter_pass",
+    "table_filter_worker",
+    "tree_filter_accepts_row",
+    "tree_filter_pass",
+    "delegate_paint",
+    "delegate_create_editor",
+    "text_editor_set_text",
+    "text_editor_get_text",
+    "trigger_table_filter",
+    "trigger_tree_filter"
+};
+
+// Counters of a probe.
+struct ProbeCounters {
+    QAtomicInteger<quint64> calls;
+    QAtomicInteger<quint64> total_ns;
+    QAtomicInteger<quint64> max_ns;
+    QAtomicInteger<quint64> histogram[HISTOGRAM_BUCKETS];
+};
+
+QAtomicInt instrumentation_enabled(0);
+static ProbeCounters probes[static_cast<int>(InstrumentationProbe::Count)];
+
+// Function to turn the instrumentation on or off, from Rust. Counters are kept when turning it off.
+extern "C" void set_instrumentation_enabled(bool enabled) {
+    instrumentation_enabled.storeRelaxed(enabled ? 1 : 0);
+}
+
+// Function to know if the instrumentation is on, from Rust.
+extern "C" bool is_instrumentation_enabled() {
+    return instrumentation_enabled.loadRelaxed() != 0;
+}
+
+// Function to get the counters of all the probes, as JSON. For each probe we get the calls, total, mean and max time,
+// percentiles estimated from the histogram (the upper bound of the bucket they fall in), and the histogram itself, up to its last used bucket.
+extern "C" void get_instrumentation_snapshot(QString* snapshot) {
+    if (snapshot == nullptr) {
+        return;
+    }
+
+    QJsonArray probe_list;
+    for (int probe = 0; probe < static_cast<int>(InstrumentationProbe::Count); ++probe) {
+        const ProbeCounters &counters = probes[probe];
+        const quint64 calls = counters.calls.loadRelaxed();
+        const quint64 total_ns = counters.total_ns.loadRelaxed();
+
+        quint64 histogram[HISTOGRAM_BUCKETS];
+        quint64 histogram_calls = 0;
+        int last_bucket = -1;
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+            histogram[bucket] = counters.histogram[bucket].loadRelaxed();
+            histogram_calls += histogram[bucket];
+            if (histogram[bucket] != 0) {
+                last_bucket = bucket;
+            }
+        }
+
+        QJsonArray buckets;
+        for (int bucket = 0; bucket <= last_bucket; ++bucket) {
+            buckets.append(static_cast<double>(histogram[bucket]));
+        }
+
+        QJsonObject entry;
+        entry["name"] = QString::fromLatin1(PROBE_NAMES[probe]);
+        entry["calls"] = static_cast<double>(calls);
+        entry["total_us"] = static_cast<double>(total_ns) / 1000.0;
+        entry["mean_us"] = calls > 0 ? static_cast<double>(total_ns) / 1000.0 / static_cast<double>(calls) : 0.0;
+        entry["max_us"] = static_cast<double>(counters.max_ns.loadRelaxed()) / 1000.0;
+
+        const double percentiles[] = {0.5, 0.95, 0.99};
+        const char* const percentile_names[] = {"p50_us", "p95_us", "p99_us"};
+        for (int percentile = 0; percentile < 3; ++percentile) {
+            const double target = percentiles[percentile] * static_cast<double>(histogram_calls);
+            quint64 seen = 0;
+            double bound_us = 0.0;
+            for (int bucket = 0; bucket <= last_bucket; ++bucket) {
+                seen += histogram[bucket];
+                if (static_cast<double>(seen) >= target) {
+                    bound_us = static_cast<double>(Q_UINT64_C(1) << (bucket + 1)) / 1000.0;
+                    break;
+                }
+            }
+            entry[percentile_names[percentile]] = bound_us;
+        }
+
+        entry["histogram"] = buckets;
+        probe_list.append(entry);
+    }
+
+    QJsonObject report;
+    report["enabled"] = is_instrumentation_enabled();
+    report["probes"] = probe_list;
+    *snapshot = QString::fromUtf8(QJsonDocument(report).toJson(QJsonDocument::Compact));
+}
+
+// Function to reset all the counters, from Rust.
+extern "C" void reset_instrumentation() {
+    for (ProbeCounters &counters: probes) {
+        counters.calls.storeRelaxed(0);
+        counters.total_ns.storeRelaxed(0);
+        counters.max_ns.storeRelaxed(0);
+        for (QAtomicInteger<quint64> &bucket: counters.histogram) {
+            bucket.storeRelaxed(0);
+        }
+    }
+}
+
+// Function to record a call to a probe. Only called while the instrumentation is on.
+void recordInstrumentation(InstrumentationProbe probe, qint64 duration_ns) {
+    ProbeCounters &counters = probes[static_cast<int>(probe)];
+    const quint64 duration = duration_ns > 0 ? static_cast<quint64>(duration_ns) : 0;
+
+    counters.calls.fetchAndAddRelaxed(1);
+    counters.total_ns.fetchAndAddRelaxed(duration);
+
+    quint64 max = counters.max_ns.loadRelaxed();
+    while (duration > max && !counters.max_ns.testAndSetRelaxed(max, duration, max)) {}
+
+    const int bucket = qMin(63 - static_cast<int>(qCountLeadingZeroBits(duration | 1)), HISTOGRAM_BUCKETS - 1);
+    counters.histogram[bucket].fetchAndAddRelaxed(1);
+}
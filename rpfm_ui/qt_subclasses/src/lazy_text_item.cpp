@@ -0,0 +1,96 @@
+#include "lazy_text_item.h"
+#include <cstring>
+
+// Bits of the roles a LazyTextItem decodes from its buffer.
+const quint8 LAZY_ROLE_TEXT = 1;
+const quint8 LAZY_ROLE_SOURCE = 2;
+const quint8 LAZY_ROLE_TOOLTIP = 4;
+
+// Role of the source value of a cell, as the table views use it.
+const int SOURCE_VALUE_ROLE = 31;
+
+// Constructor of LazyTextBuffer.
+LazyTextBuffer::LazyTextBuffer(const QByteArray &data, const QString &tooltip_template, int cache_size):
+    tooltip_template(tooltip_template),
+    data(data),
+    decoded_texts(qMax(0, cache_size)) {}
+
+// Function to decode the text at the provided offset. Reads going through an entire column should skip the cache, so they don't flush it.
+QString LazyTextBuffer::text(qint64 offset, bool use_cache) const {
+    if (offset < 0 || offset + static_cast<qint64>(sizeof(quint32)) > data.size()) {
+        return QString();
+    }
+
+    if (use_cache) {
+        if (const QString *cached = decoded_texts.object(offset)) {
+            return *cached;
+        }
+    }
+
+    quint32 length = 0;
+    std::memcpy(&length, data.constData() + offset, sizeof(quint32));
+    const qint64 start = offset + static_cast<qint64>(sizeof(quint32));
+    if (start + static_cast<qint64>(length) > data.size()) {
+        return QString();
+    }
+
+    QString text = QString::fromUtf8(data.constData() + start, static_cast<int>(length));
+    if (use_cache) {
+        decoded_texts.insert(offset, new QString(text));
+    }
+
+    return text;
+}
+
+// Constructor of LazyTextItem. Its text is at the provided offset of the buffer.
+LazyTextItem::LazyTextItem(const QSharedPointer<const LazyTextBuffer> &buffer, qint64 offset): QStandardItem(), buffer(buffer), offset(offset) {}
+
+// Function to get which of the decoded roles is the provided one, if any.
+quint8 LazyTextItem::lazyRole(int role) {
+    switch (role) {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return LAZY_ROLE_TEXT;
+        case SOURCE_VALUE_ROLE:
+            return LAZY_ROLE_SOURCE;
+        case Qt::ToolTipRole:
+            return LAZY_ROLE_TOOLTIP;
+        default:
+            return 0;
+    }
+}
+
+// Function to get the data of a role. The text roles come from the buffer until they're set.
+QVariant LazyTextItem::data(int role) const {
+    const quint8 lazy_role = lazyRole(role);
+    if (lazy_role == 0 || (stored_roles & lazy_role)) {
+        return QStandardItem::data(role);
+    }
+
+    const QString text = buffer->text(offset);
+    if (lazy_role == LAZY_ROLE_TOOLTIP) {
+        return QVariant(buffer->tooltip_template.arg(text));
+    }
+
+    return QVariant(text);
+}
+
+// Function to set the data of a role. Setting one of the text roles stops it from being read from the buffer.
+void LazyTextItem::setData(const QVariant &value, int role) {
+    stored_roles |= lazyRole(role);
+    QStandardItem::setData(value, role);
+}
+
+// Function to copy the item. The copy shares the buffer.
+QStandardItem *LazyTextItem::clone() const {
+    return new LazyTextItem(*this);
+}
+
+// Function to get the text shown in the cell.
+QString LazyTextItem::displayText(bool use_cache) const {
+    if (stored_roles & LAZY_ROLE_TEXT) {
+        return QStandardItem::data(Qt::DisplayRole).toString();
+    }
+
+    return buffer->text(offset, use_cache);
+}
@@ -0,0 +1,174 @@
+#include "literal_matcher.h"
+#include <QtCore/qalgorithms.h>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LITERAL_MATCHER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LITERAL_MATCHER_AVX2_TARGET
+#else
+#define LITERAL_MATCHER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define LITERAL_MATCHER_NEON
+#include <arm_neon.h>
+#endif
+
+// All the vectorized versions work the same way: they compare a block of positions against the first and the last
+// character of the literal at once, and only the positions where both match get fully compared.
+//
+// They return the position they stopped at, so the scalar version can check the remaining tail.
+
+// Function to check if the literal is at the provided position of the text. First and last characters are already known to match.
+static inline bool matchesAt(const ushort *text, const ushort *literal, int literal_length) {
+    return literal_length <= 2 || std::memcmp(text + 1, literal + 1, (literal_length - 2) * sizeof(ushort)) == 0;
+}
+
+// Scalar search, from the provided position until the end of the text.
+static bool containsScalar(const ushort *text, int text_length, const ushort *literal, int literal_length, int start) {
+    const ushort first = literal[0];
+    const ushort last = literal[literal_length - 1];
+    for (int i = start; i + literal_length <= text_length; ++i) {
+        if (text[i] == first && text[i + literal_length - 1] == last && matchesAt(text + i, literal, literal_length)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#if defined(LITERAL_MATCHER_X86)
+
+// SSE2 search, 8 characters per block. SSE2 is always there on x86_64, and on every x86 CPU Qt 5 supports.
+static bool containsSse2(const ushort *text, int text_length, const ushort *literal, int literal_length, int &position) {
+    const __m128i first = _mm_set1_epi16(static_cast<short>(literal[0]));
+    const __m128i last = _mm_set1_epi16(static_cast<short>(literal[literal_length - 1]));
+
+    int i = 0;
+    for (; i + literal_length - 1 + 8 <= text_length; i += 8) {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + literal_length - 1));
+        const __m128i matches = _mm_and_si128(_mm_cmpeq_epi16(block_first, first), _mm_cmpeq_epi16(block_last, last));
+
+        // Two bits per character, so we only keep the even ones.
+        uint mask = static_cast<uint>(_mm_movemask_epi8(matches)) & 0x5555u;
+        while (mask != 0) {
+            const int lane = qCountTrailingZeroBits(mask) / 2;
+            if (matchesAt(text + i + lane, literal, literal_length)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    position = i;
+    return false;
+}
+
+// AVX2 search, 16 characters per block.
+LITERAL_MATCHER_AVX2_TARGET
+static bool containsAvx2(const ushort *text, int text_length, const ushort *literal, int literal_length, int &position) {
+    const __m256i first = _mm256_set1_epi16(static_cast<short>(literal[0]));
+    const __m256i last = _mm256_set1_epi16(static_cast<short>(literal[literal_length - 1]));
+
+    int i = 0;
+    for (; i + literal_length - 1 + 16 <= text_length; i += 16) {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + literal_length - 1));
+        const __m256i matches = _mm256_and_si256(_mm256_cmpeq_epi16(block_first, first), _mm256_cmpeq_epi16(block_last, last));
+
+        uint mask = static_cast<uint>(_mm256_movemask_epi8(matches)) & 0x55555555u;
+        while (mask != 0) {
+            const int lane = qCountTrailingZeroBits(mask) / 2;
+            if (matchesAt(text + i + lane, literal, literal_length)) {
+                return true;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    position = i;
+    return false;
+}
+
+// Function to check, only once, if the CPU and the OS support AVX2.
+static bool hasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // The OS has to save the AVX registers too, or we cannot use them.
+    __cpuid(info, 1);
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx = (info[2] & (1 << 28)) != 0;
+    if (!has_osxsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif defined(LITERAL_MATCHER_NEON)
+
+// NEON search, 8 characters per block.
+static bool containsNeon(const ushort *text, int text_length, const ushort *literal, int literal_length, int &position) {
+    const uint16x8_t first = vdupq_n_u16(literal[0]);
+    const uint16x8_t last = vdupq_n_u16(literal[literal_length - 1]);
+
+    int i = 0;
+    for (; i + literal_length - 1 + 8 <= text_length; i += 8) {
+        const uint16x8_t block_first = vld1q_u16(reinterpret_cast<const uint16_t*>(text + i));
+        const uint16x8_t block_last = vld1q_u16(reinterpret_cast<const uint16_t*>(text + i + literal_length - 1));
+        const uint16x8_t matches = vandq_u16(vceqq_u16(block_first, first), vceqq_u16(block_last, last));
+
+        // Narrowing leaves a byte per character, all ones if it matched.
+        quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(matches, 4)), 0);
+        while (mask != 0) {
+            const int lane = qCountTrailingZeroBits(mask) / 8;
+            if (matchesAt(text + i + lane, literal, literal_length)) {
+                return true;
+            }
+            mask &= ~(quint64(0xFF) << (lane * 8));
+        }
+    }
+
+    position = i;
+    return false;
+}
+
+#endif
+
+bool literal_contains(const ushort *text, int text_length, const ushort *literal, int literal_length) {
+    if (literal_length == 0) {
+        return true;
+    }
+
+    if (literal_length > text_length) {
+        return false;
+    }
+
+    int position = 0;
+
+#if defined(LITERAL_MATCHER_X86)
+    static const bool use_avx2 = hasAvx2();
+    if (use_avx2 ? containsAvx2(text, text_length, literal, literal_length, position) : containsSse2(text, text_length, literal, literal_length, position)) {
+        return true;
+    }
+#elif defined(LITERAL_MATCHER_NEON)
+    if (containsNeon(text, text_length, literal, literal_length, position)) {
+        return true;
+    }
+#endif
+
+    return containsScalar(text, text_length, literal, literal_length, position);
+}
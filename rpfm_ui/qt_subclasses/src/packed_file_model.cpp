@@ -1,40 +1,325 @@
 #include "packed_file_model.h"
+#include <QStringRef>
+#include <QVariantList>
+#include <cstring>
+
+// Roles and values of the items, as the Rust side uses them.
+const int ITEM_TYPE = 20;
+const int ITEM_STATUS = 21;
+const int ITEM_TYPE_FILE = 1;
+const int ITEM_TYPE_FOLDER = 2;
+const int ITEM_TYPE_PACKFILE = 3;
+const int ITEM_STATUS_PRISTINE = 0;
+
+// Role with the pending contents of a folder: a list with the first and last (exclusive) entries of the path table, and the depth of its children.
+const int PENDING_CHILDREN_ROLE = 40;
+
+// Id of the icon of the folders.
+const int ICON_FOLDER = 0;
 
 // Fuction to be able to create a PackedFileModel from other languages.
 extern "C" QStandardItemModel* new_packed_file_model() {
     return dynamic_cast<QStandardItemModel*>(new PackedFileModel());
 }
 
+// Function to load lazily the PackedFiles of a PackFile under its root item, from Rust.
+// It returns false if the model is not a PackedFileModel, so the items have to be created beforehand.
+//
+// The buffer has, for each PackedFile, in the same sorting as the TreeView: its path (with its parts joined by /) and its tooltip, both as
+// a u32 with their length in bytes followed by their UTF-8 text, and the id of its icon (u8), as registered with packed_file_model_register_icon.
+extern "C" bool packed_file_model_load_lazy(QStandardItemModel* model, QStandardItem* root, const char* buffer, qint64 buffer_size, int count) {
+    PackedFileModel* packed_file_model = dynamic_cast<PackedFileModel*>(model);
+    if (packed_file_model == nullptr || root == nullptr) {
+        return false;
+    }
+
+    return packed_file_model->loadLazy(root, buffer, buffer_size, count);
+}
+
+// Function to register one of the icons of the path table, from Rust. The id 0 is for folders.
+extern "C" void packed_file_model_register_icon(QStandardItemModel* model, int id, const QIcon* icon) {
+    PackedFileModel* packed_file_model = dynamic_cast<PackedFileModel*>(model);
+    if (packed_file_model != nullptr && icon != nullptr) {
+        packed_file_model->registerIcon(id, *icon);
+    }
+}
+
+// Function to make sure all the items of a path exist, so Rust can walk down to it.
+extern "C" void packed_file_model_fetch_path(QStandardItemModel* model, QStringList* path) {
+    PackedFileModel* packed_file_model = dynamic_cast<PackedFileModel*>(model);
+    if (packed_file_model != nullptr && path != nullptr) {
+        packed_file_model->fetchPath(*path);
+    }
+}
+
+// Function to make sure all the items under an item exist. A null item means the entire model.
+extern "C" void packed_file_model_fetch_all(QStandardItemModel* model, QStandardItem* item) {
+    PackedFileModel* packed_file_model = dynamic_cast<PackedFileModel*>(model);
+    if (packed_file_model != nullptr) {
+        packed_file_model->fetchAll(item);
+    }
+}
+
+// Constructor of PackedFileModel.
+PackedFileModel::PackedFileModel(QObject *parent): QStandardItemModel(parent) {}
+
 // Function to check if an item can be drag or drop into.
 //
+// The items get the drag and drop flags of their type when they're created:
+// - Drag for everything except the PackFile
+// - Drop for eveything except files.
+//
 // TODO: Expand this to ensure only unique items can be drop into folders, so we don't have duplicate names in the same folder.
 Qt::ItemFlags PackedFileModel::flags(const QModelIndex &index) const {
     Qt::ItemFlags defaultFlags = QStandardItemModel::flags(index);
-    defaultFlags = defaultFlags &~ Qt::ItemIsDragEnabled;
-    defaultFlags = defaultFlags &~ Qt::ItemIsDropEnabled;
 
-    // In case of valid index, allow:
-    // - Drag for everything except the PackFile
-    // - Drop for eveything except files.
-    if (index.isValid()) {
-        QStandardItem* item = PackedFileModel::itemFromIndex(index);
-        int item_type = item->data(20).toInt();
-        if (item_type == 1) {
-            return Qt::ItemIsDragEnabled | defaultFlags;
+    // In case of invalid index, do not allow anything.
+    if (!index.isValid()) {
+        defaultFlags = defaultFlags &~ Qt::ItemIsDragEnabled;
+        defaultFlags = defaultFlags &~ Qt::ItemIsDropEnabled;
+    }
+
+    return defaultFlags;
+}
+
+// Function to check if an item has children. Pending folders have them, even if their items don't exist yet.
+bool PackedFileModel::hasChildren(const QModelIndex &parent) const {
+    if (parent.isValid() && parent.column() == 0) {
+        QStandardItem* item = itemFromIndex(parent);
+        if (item != nullptr && item->data(PENDING_CHILDREN_ROLE).isValid()) {
+            return true;
         }
-        else if (item_type == 2) {
-            return Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled | defaultFlags;
+    }
+
+    return QStandardItemModel::hasChildren(parent);
+}
+
+// Function to check if the view can ask for the children of an item.
+bool PackedFileModel::canFetchMore(const QModelIndex &parent) const {
+    if (parent.isValid() && parent.column() == 0) {
+        QStandardItem* item = itemFromIndex(parent);
+        return item != nullptr && item->data(PENDING_CHILDREN_ROLE).isValid();
+    }
+
+    return false;
+}
+
+// Function called by the view when it needs the children of an item (for example, when expanding it).
+void PackedFileModel::fetchMore(const QModelIndex &parent) {
+    if (parent.isValid() && parent.column() == 0) {
+        fetchChildren(itemFromIndex(parent));
+    }
+}
+
+// Function to replace the path table, and make the root item pending of all its entries.
+bool PackedFileModel::loadLazy(QStandardItem* root, const char* buffer, qint64 buffer_size, int count) {
+    QSharedPointer<QVector<PackedFileEntry>> table(new QVector<PackedFileEntry>());
+    table->reserve(count);
+
+    // Read a length-prefixed UTF-8 text. If the buffer ends early, the rest of the entries are dropped.
+    qint64 position = 0;
+    bool truncated = buffer == nullptr;
+    auto readText = [&]() -> QString {
+        quint32 length = 0;
+        if (truncated || position + static_cast<qint64>(sizeof(length)) > buffer_size) {
+            truncated = true;
+            return QString();
         }
-        else if (item_type == 3) {
-            return Qt::ItemIsDropEnabled | defaultFlags;
+
+        std::memcpy(&length, buffer + position, sizeof(length));
+        position += sizeof(length);
+        if (position + static_cast<qint64>(length) > buffer_size) {
+            truncated = true;
+            return QString();
         }
-        else {
-            return defaultFlags ;
+
+        QString text = QString::fromUtf8(buffer + position, static_cast<int>(length));
+        position += length;
+        return text;
+    };
+
+    for (int index = 0; index < count && !truncated; ++index) {
+        PackedFileEntry entry;
+        entry.path = readText();
+        entry.tooltip = readText();
+        if (truncated || position >= buffer_size) {
+            break;
         }
+
+        entry.icon = static_cast<quint8>(buffer[position]);
+        position++;
+        table->append(entry);
     }
 
-    // In case of invalid index, do not allow anything.
+    path_table = table;
+    root->setData(QVariantList({0, table->count(), 0}), PENDING_CHILDREN_ROLE);
+    return true;
+}
+
+// Function to register one of the icons the items of the path table use.
+void PackedFileModel::registerIcon(int id, const QIcon &icon) {
+    icons.insert(id, icon);
+}
+
+// Function to create the row (item and status item) of a file or folder, the same way the Rust side creates them.
+QList<QStandardItem*> PackedFileModel::newRow(const QString &name, int item_type, const QString &tooltip, int icon) const {
+    QStandardItem* item = new QStandardItem(name);
+    item->setEditable(false);
+    item->setData(QVariant(item_type), ITEM_TYPE);
+    item->setDragEnabled(item_type != ITEM_TYPE_PACKFILE);
+    item->setDropEnabled(item_type != ITEM_TYPE_FILE);
+    if (!tooltip.isEmpty()) {
+        item->setToolTip(tooltip);
+    }
+
+    QHash<int, QIcon>::const_iterator icon_iter = icons.constFind(icon);
+    if (icon_iter != icons.constEnd()) {
+        item->setIcon(icon_iter.value());
+    }
+
+    QStandardItem* status_item = new QStandardItem();
+    status_item->setData(QVariant(ITEM_STATUS_PRISTINE), ITEM_STATUS);
+    status_item->setFlags(Qt::ItemIsSelectable);
+
+    return QList<QStandardItem*>({item, status_item});
+}
+
+// Function to get a part of a path, and if it's the last one.
+static QStringRef pathPart(const QString &path, int depth, bool &is_last) {
+    int start = 0;
+    for (int part = 0; part < depth; ++part) {
+        start = path.indexOf(QLatin1Char('/'), start);
+        if (start == -1) {
+            is_last = true;
+            return QStringRef();
+        }
+        start++;
+    }
+
+    int end = path.indexOf(QLatin1Char('/'), start);
+    is_last = end == -1;
+    return QStringRef(&path, start, (end == -1 ? path.size() : end) - start);
+}
+
+// Function to create the children of a pending folder. Subfolders are created as pending folders themselves.
+//
+// As the path table is sorted, the contents of each subfolder are a contiguous range of the range of its parent.
+// It returns false if the item was not pending.
+bool PackedFileModel::fetchChildren(QStandardItem* item) {
+    if (item == nullptr || path_table.isNull()) {
+        return false;
+    }
+
+    QVariant pending = item->data(PENDING_CHILDREN_ROLE);
+    if (!pending.isValid()) {
+        return false;
+    }
+
+    // Clear it first, so the view doesn't try to fetch it again while we add the children.
+    item->setData(QVariant(), PENDING_CHILDREN_ROLE);
+
+    const QVector<PackedFileEntry> &table = *path_table;
+    QVariantList range = pending.toList();
+    int row = qMax(0, range.value(0).toInt());
+    int end = qMin(table.count(), range.value(1).toInt());
+    int depth = range.value(2).toInt();
+
+    QList<QList<QStandardItem*>> rows;
+    while (row < end) {
+        const PackedFileEntry &entry = table.at(row);
+        bool is_last = false;
+        QStringRef name = pathPart(entry.path, depth, is_last);
+
+        if (is_last) {
+            rows.append(newRow(name.toString(), ITEM_TYPE_FILE, entry.tooltip, entry.icon));
+            row++;
+            continue;
+        }
+
+        // Group all the entries of the same subfolder.
+        int group_end = row + 1;
+        while (group_end < end) {
+            bool other_is_last = false;
+            QStringRef other_name = pathPart(table.at(group_end).path, depth, other_is_last);
+            if (other_is_last || other_name != name) {
+                break;
+            }
+            group_end++;
+        }
+
+        QList<QStandardItem*> folder = newRow(name.toString(), ITEM_TYPE_FOLDER, QString(), ICON_FOLDER);
+        folder.first()->setData(QVariantList({row, group_end, depth + 1}), PENDING_CHILDREN_ROLE);
+        rows.append(folder);
+        row = group_end;
+    }
+
+    for (const QList<QStandardItem*> &new_row: rows) {
+        item->appendRow(new_row);
+    }
+
+    return true;
+}
+
+// Function to create the items of every folder in a path, so all of them can be found by walking down the tree.
+void PackedFileModel::fetchPath(const QStringList &path) {
+    QStandardItem* item = this->item(0);
+    if (item == nullptr) {
+        return;
+    }
+
+    fetchChildren(item);
+    for (int index = 0; index < path.count(); ++index) {
+        QStandardItem* found = nullptr;
+        for (int row = 0; row < item->rowCount(); ++row) {
+            QStandardItem* child = item->child(row);
+            if (child == nullptr || child->text() != path.at(index)) {
+                continue;
+            }
+
+            // Only folders can be in the middle of a path.
+            if (index < path.count() - 1 && child->data(ITEM_TYPE).toInt() != ITEM_TYPE_FOLDER) {
+                continue;
+            }
+
+            found = child;
+            if (child->data(ITEM_TYPE).toInt() == ITEM_TYPE_FOLDER) {
+                break;
+            }
+        }
+
+        if (found == nullptr) {
+            return;
+        }
+
+        item = found;
+        fetchChildren(item);
+    }
+}
+
+// Function to create all the pending items under an item.
+void PackedFileModel::fetchAll(QStandardItem* item) {
+    if (path_table.isNull()) {
+        return;
+    }
+
+    QList<QStandardItem*> stack;
+    if (item != nullptr) {
+        stack.append(item);
+    }
     else {
-        return defaultFlags;
+        for (int row = 0; row < rowCount(); ++row) {
+            stack.append(this->item(row));
+        }
+    }
+
+    while (!stack.isEmpty()) {
+        QStandardItem* current = stack.takeLast();
+        fetchChildren(current);
+        for (int row = 0; row < current->rowCount(); ++row) {
+            QStandardItem* child = current->child(row);
+            if (child != nullptr && child->data(ITEM_TYPE).toInt() != ITEM_TYPE_FILE) {
+                stack.append(child);
+            }
+        }
     }
 }
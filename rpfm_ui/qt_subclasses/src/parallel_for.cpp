@@ -0,0 +1,74 @@
+#include "parallel_for.h"
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+// Shared state of a parallel_for. Chunks are claimed through next_chunk, so whoever gets first to a chunk runs it.
+struct ParallelForState {
+    std::function<void(int, int)> worker;
+    int count;
+    int chunk_size;
+    int chunks;
+    QAtomicInt next_chunk;
+    QSemaphore done;
+
+    // Function to run chunks until there are none left.
+    void runChunks() {
+        int chunk;
+        while ((chunk = next_chunk.fetchAndAddOrdered(1)) < chunks) {
+            int begin = chunk * chunk_size;
+            worker(begin, qMin(begin + chunk_size, count));
+            done.release();
+        }
+    }
+};
+
+// Runnable for the workers of a parallel_for. It frees itself once it's done.
+class ParallelForTask : public QRunnable {
+
+public:
+    ParallelForTask(QSharedPointer<ParallelForState> state): state(state) {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        state->runChunks();
+    }
+
+private:
+    QSharedPointer<ParallelForState> state;
+};
+
+void parallel_for(int count, int min_chunk_size, const std::function<void(int begin, int end)> &worker) {
+    if (count <= 0) {
+        return;
+    }
+
+    // Small ranges or single-core machines are not worth the threading overhead.
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int threads = qMax(1, pool->maxThreadCount());
+    int min_chunk = qMax(1, min_chunk_size);
+    int chunks = qMin(threads * 4, (count + min_chunk - 1) / min_chunk);
+    if (threads == 1 || chunks <= 1) {
+        worker(0, count);
+        return;
+    }
+
+    QSharedPointer<ParallelForState> state(new ParallelForState());
+    state->worker = worker;
+    state->count = count;
+    state->chunk_size = (count + chunks - 1) / chunks;
+    state->chunks = (count + state->chunk_size - 1) / state->chunk_size;
+    state->next_chunk = 0;
+
+    for (int i = 1; i < qMin(threads, state->chunks); ++i) {
+        pool->start(new ParallelForTask(state));
+    }
+
+    // This thread works too. And as any chunk nobody has claimed yet is run here, this never waits
+    // on a task that didn't start, even if we're called from within the pool.
+    state->runChunks();
+    state->done.acquire(state->chunks);
+}
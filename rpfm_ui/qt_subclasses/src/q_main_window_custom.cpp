@@ -1,4 +1,5 @@
 #include "q_main_window_custom.h"
+#include "settings_store.h"
 
 // Fuction to be able to create a custom QMainWindow.
 extern "C" QMainWindow* new_q_main_window_custom(bool (*are_you_sure) (QMainWindow* main_window, bool is_delete_my_mod)) {
@@ -13,13 +14,11 @@ QMainWindowCustom::QMainWindowCustom(QWidget *parent, bool (*are_you_sure_fn) (Q
 void QMainWindowCustom::closeEvent(QCloseEvent *event) {
     event->ignore();
 
-    // Save the state of the window before closing it.
-    QSettings settings("FrodoWazEre", "rpfm");
-    settings.setValue("geometry", saveGeometry());
-    settings.setValue("windowState", saveState());
-
-    // Make sure the settings are saved before closing.
-    settings.sync();
+    // Save the state of the window before closing it. This only goes to the settings store, so it doesn't block,
+    // and closing it again after cancelling just replaces it. It reaches the disk in the background, or when the program quits.
+    SettingsStore* settings = SettingsStore::instance();
+    settings->setValue("geometry", saveGeometry());
+    settings->setValue("windowState", saveState());
 
     if (are_you_sure(this, false)) {
         event->accept();
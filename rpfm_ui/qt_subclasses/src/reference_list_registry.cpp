@@ -0,0 +1,109 @@
+#include "reference_list_registry.h"
+#include <QCoreApplication>
+#include <QPointer>
+
+// Registry of the process. It belongs to the application, so it may be gone by the time the last delegates get destroyed.
+static QPointer<ReferenceListRegistry> registry;
+
+// Function to check from any other language if a list is already registered with the provided version.
+// It returns the handle of the list if it is, or -1 if it needs to be (re)registered.
+extern "C" int reference_list_find(QString *key, quint64 version) {
+    if (key == nullptr) {
+        return -1;
+    }
+
+    return ReferenceListRegistry::instance()->find(*key, version);
+}
+
+// Function to register a list from any other language. It returns the handle the delegates need to use it.
+extern "C" int reference_list_register(QString *key, quint64 version, QStringList *values) {
+    if (key == nullptr) {
+        return -1;
+    }
+
+    return ReferenceListRegistry::instance()->registerList(*key, version, values != nullptr ? *values : QStringList());
+}
+
+// Constructor of ReferenceListRegistry.
+ReferenceListRegistry::ReferenceListRegistry(QObject *parent): QObject(parent) {}
+
+// Function to get the registry. It's created the first time it's requested, and lives as long as the application.
+ReferenceListRegistry *ReferenceListRegistry::instance() {
+    if (registry.isNull()) {
+        registry = new ReferenceListRegistry(QCoreApplication::instance());
+    }
+
+    return registry.data();
+}
+
+// Function to get the handle of a list, but only if it's registered with the provided version.
+int ReferenceListRegistry::find(const QString &key, quint64 version) const {
+    int handle = handles.value(key, -1);
+    if (handle == -1 || entries.value(handle).version != version) {
+        return -1;
+    }
+
+    return handle;
+}
+
+// Function to register a list. If the key already has a list with the same version, the existing one is kept.
+//
+// Otherwise the list is replaced, and the delegates using it are notified. Delegates with a copy of the old list keep it valid
+// until they take the new one, thanks to the implicit sharing.
+int ReferenceListRegistry::registerList(const QString &key, quint64 version, const QStringList &values) {
+    int handle = handles.value(key, -1);
+    if (handle == -1) {
+        Entry entry;
+        entry.key = key;
+        entry.version = version;
+        entry.values = values;
+
+        handle = next_handle++;
+        entries.insert(handle, entry);
+        handles.insert(key, handle);
+        return handle;
+    }
+
+    Entry &entry = entries[handle];
+    if (entry.version != version) {
+        entry.version = version;
+        entry.values = values;
+        emit listChanged(handle);
+    }
+
+    return handle;
+}
+
+// Function to get a (shallow) copy of a list.
+QStringList ReferenceListRegistry::values(int handle) const {
+    return entries.value(handle).values;
+}
+
+// Function to mark a list as in use by one more delegate.
+void ReferenceListRegistry::acquire(int handle) {
+    auto entry = entries.find(handle);
+    if (entry != entries.end()) {
+        entry->users++;
+    }
+}
+
+// Function to mark a list as no longer in use by a delegate. It does nothing if the registry is already gone.
+void ReferenceListRegistry::release(int handle) {
+    if (!registry.isNull()) {
+        registry->releaseList(handle);
+    }
+}
+
+// Function to drop a delegate from the users of a list, and the list itself if that was its last user.
+void ReferenceListRegistry::releaseList(int handle) {
+    auto entry = entries.find(handle);
+    if (entry == entries.end()) {
+        return;
+    }
+
+    entry->users--;
+    if (entry->users <= 0) {
+        handles.remove(entry->key);
+        entries.erase(entry);
+    }
+}
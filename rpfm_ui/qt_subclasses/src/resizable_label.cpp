@@ -1,5 +1,14 @@
 #include "resizable_label.h"
-#include <QDebug>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+
+// Amount of scaled pixmaps the label keeps.
+const int SCALED_CACHE_LIMIT = 4;
+
+// Time in ms the label waits after the last resize to scale the image.
+const int SCALE_DELAY = 80;
 
 // Function to create the resizable label from Rust.
 extern "C" QLabel* new_resizable_label(QWidget *parent, QPixmap *pixmap) {
@@ -9,16 +18,46 @@ extern "C" QLabel* new_resizable_label(QWidget *parent, QPixmap *pixmap) {
 
 extern "C" void set_pixmap_on_resizable_label(QLabel *label, QPixmap *pixmap) {
     ResizableLabel* resizable_label = dynamic_cast<ResizableLabel*>(label);
-    resizable_label->pix = *pixmap;
-    resizable_label->setPixmap(resizable_label->scaledPixmap());
+    resizable_label->setSourcePixmap(pixmap != nullptr ? *pixmap : QPixmap());
 }
 
+// Runnable to scale an image in the background. Once done, the result is sent back to the label from the GUI thread, if the label still exists.
+class ScaleImageTask : public QRunnable {
+
+public:
+    ScaleImageTask(ResizableLabel *label, int generation, const QImage &image, const QSize &size):
+        label(label), generation(generation), image(image), size(size) {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        QImage scaled = image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QPointer<ResizableLabel> target = label;
+        int target_generation = generation;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [target, target_generation, scaled]() {
+            if (!target.isNull()) {
+                target->installScaledImage(target_generation, scaled);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QPointer<ResizableLabel> label;
+    int generation;
+    QImage image;
+    QSize size;
+};
 
 ResizableLabel::ResizableLabel(QWidget *parent, QPixmap *pixmap): QLabel(parent) {
     this->setMinimumSize(1,1);
     setScaledContents(false);
-    pix = *pixmap;
-    setPixmap(scaledPixmap());
+
+    scale_timer = new QTimer(this);
+    scale_timer->setSingleShot(true);
+    scale_timer->setInterval(SCALE_DELAY);
+    connect(scale_timer, &QTimer::timeout, this, [this]() { startScaling(); });
+
+    setSourcePixmap(pixmap != nullptr ? *pixmap : QPixmap());
 }
 
 int ResizableLabel::heightForWidth( int width ) const {
@@ -30,17 +69,102 @@ QSize ResizableLabel::sizeHint() const {
     return QSize( w, heightForWidth(w) );
 }
 
-QPixmap ResizableLabel::scaledPixmap() const {
+// Function to replace the pixmap of the label. Whatever was scaled from the old one gets discarded.
+void ResizableLabel::setSourcePixmap(const QPixmap &pixmap) {
+    pix = pixmap;
+    source_image = pix.toImage();
+    scaled_cache.clear();
+    scale_generation++;
+    source_generation = scale_generation;
+    updateScaledPixmap();
+}
+
+// Function to get the size the pixmap should be shown at. Images are only scaled down, never up.
+QSize ResizableLabel::targetSize() const {
     if (pix.height() > this->height()) {
-        return pix.scaled(this->size(), Qt::KeepAspectRatio);
+        return pix.size().scaled(this->size(), Qt::KeepAspectRatio);
     }
     else {
+        return pix.size();
+    }
+}
+
+// Function to get the pixmap to show right now: the source, a cached one of the right size, or a quick scale of the closest cached one.
+QPixmap ResizableLabel::scaledPixmap() const {
+    QSize size = targetSize();
+    if (size == pix.size() || size.isEmpty()) {
         return pix;
     }
+
+    // Scaling from the closest bigger pixmap keeps the quick scale cheap, without losing much detail.
+    const QPixmap *closest = &pix;
+    for (const QPixmap &cached: scaled_cache) {
+        if (cached.size() == size) {
+            return cached;
+        }
+
+        if (cached.width() >= size.width() && cached.width() < closest->width()) {
+            closest = &cached;
+        }
+    }
+
+    return closest->scaled(size, Qt::KeepAspectRatio, Qt::FastTransformation);
+}
+
+// Function to show the best pixmap we have for the current size, and schedule a proper scale if it's not the right one.
+void ResizableLabel::updateScaledPixmap() {
+    if (pix.isNull()) {
+        QLabel::setPixmap(pix);
+        return;
+    }
+
+    QSize size = targetSize();
+    bool exact = size == pix.size() || size.isEmpty();
+    for (const QPixmap &cached: scaled_cache) {
+        if (cached.size() == size) {
+            exact = true;
+            break;
+        }
+    }
+
+    QLabel::setPixmap(scaledPixmap());
+    if (exact) {
+        scale_timer->stop();
+    } else {
+        scale_timer->start();
+    }
+}
+
+// Function to scale the image to the current size in the background.
+void ResizableLabel::startScaling() {
+    QSize size = targetSize();
+    if (source_image.isNull() || size.isEmpty()) {
+        return;
+    }
+
+    scale_generation++;
+    QThreadPool::globalInstance()->start(new ScaleImageTask(this, scale_generation, source_image, size));
+}
+
+// Function to receive a scaled image from the background. It's cached even if it's outdated, as the label may go back to that size.
+// Images scaled from a previous pixmap are just dropped.
+void ResizableLabel::installScaledImage(int generation, const QImage &image) {
+    if (image.isNull() || generation <= source_generation) {
+        return;
+    }
+
+    scaled_cache.prepend(QPixmap::fromImage(image));
+    while (scaled_cache.count() > SCALED_CACHE_LIMIT) {
+        scaled_cache.removeLast();
+    }
+
+    if (generation == scale_generation && image.size() == targetSize()) {
+        QLabel::setPixmap(scaled_cache.first());
+    }
 }
 
 void ResizableLabel::resizeEvent(QResizeEvent*) {
     if(!pix.isNull()) {
-        QLabel::setPixmap(scaledPixmap());
+        updateScaledPixmap();
     }
 }
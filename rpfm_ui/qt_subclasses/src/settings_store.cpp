@@ -0,0 +1,117 @@
+#include "settings_store.h"
+#include <QCoreApplication>
+#include <QMutexLocker>
+#include <QPointer>
+
+// Store of the process, parented to the application so it gets flushed and destroyed with it.
+static QMutex store_mutex;
+static QPointer<SettingsStore> store;
+
+// Function to get the store of the process, creating it the first time.
+SettingsStore* SettingsStore::instance() {
+    QMutexLocker locker(&store_mutex);
+    if (store.isNull()) {
+        store = new SettingsStore(QCoreApplication::instance());
+    }
+
+    return store.data();
+}
+
+// Constructor of SettingsStore. The last writes get flushed when the application is about to quit.
+SettingsStore::SettingsStore(QObject *parent): QObject(parent), settings("FrodoWazEre", "rpfm") {
+    flush_timer = new QTimer(this);
+    flush_timer->setSingleShot(true);
+    connect(flush_timer, &QTimer::timeout, this, &SettingsStore::flush);
+
+    flush_pool = new QThreadPool(this);
+    flush_pool->setMaxThreadCount(1);
+
+    if (QCoreApplication* application = QCoreApplication::instance()) {
+        connect(application, &QCoreApplication::aboutToQuit, this, &SettingsStore::flushNow);
+    }
+}
+
+// Destructor. Just in case the application didn't quit normally, anything pending is written here.
+SettingsStore::~SettingsStore() {
+    flushNow();
+}
+
+// Function to get the value of a setting. Only the first read of each key goes to the backend.
+QVariant SettingsStore::value(const QString &key, const QVariant &default_value) {
+    QMutexLocker locker(&mutex);
+    auto cached = values.constFind(key);
+    if (cached == values.constEnd()) {
+        cached = values.insert(key, settings.value(key));
+    }
+
+    return cached.value().isValid() ? cached.value() : default_value;
+}
+
+// Function to change the value of a setting. It's visible right away through the store, and reaches the backend with the next flush.
+void SettingsStore::setValue(const QString &key, const QVariant &value) {
+    {
+        QMutexLocker locker(&mutex);
+        values.insert(key, value);
+        pending.insert(key, value);
+    }
+
+    // The timer lives in the GUI thread, so it has to be started from there.
+    QMetaObject::invokeMethod(this, [this]() {
+        if (!flush_timer->isActive()) {
+            flush_timer->start(flush_delay);
+        }
+    });
+}
+
+// Function to drop the cached values, so they get read again from the backend. Pending writes are kept.
+void SettingsStore::reload() {
+    QMutexLocker locker(&mutex);
+    values = pending;
+}
+
+// Function to send the pending writes to the backend, in the background.
+void SettingsStore::flush() {
+    QHash<QString, QVariant> values_to_write;
+    {
+        QMutexLocker locker(&mutex);
+        values_to_write.swap(pending);
+    }
+
+    if (!values_to_write.isEmpty()) {
+        flush_pool->start(new SettingsFlushTask(settings.organizationName(), settings.applicationName(), values_to_write));
+    }
+}
+
+// Function to write the pending writes to the backend right away, waiting for the ones already in flight. This is what blocks, so it's only for shutdown.
+void SettingsStore::flushNow() {
+    flush_timer->stop();
+    flush_pool->waitForDone();
+
+    QMutexLocker locker(&mutex);
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    for (auto value = pending.constBegin(); value != pending.constEnd(); ++value) {
+        settings.setValue(value.key(), value.value());
+    }
+
+    pending.clear();
+    settings.sync();
+}
+
+// Constructor of SettingsFlushTask.
+SettingsFlushTask::SettingsFlushTask(const QString &organization, const QString &application, const QHash<QString, QVariant> &values):
+    organization(organization),
+    application(application),
+    values(values) {}
+
+// Function to write the batch. It uses its own QSettings, as they can't be shared between threads.
+void SettingsFlushTask::run() {
+    QSettings settings(organization, application);
+    for (auto value = values.constBegin(); value != values.constEnd(); ++value) {
+        settings.setValue(value.key(), value.value());
+    }
+
+    settings.sync();
+}
@@ -1,10 +1,10 @@
 #include "spinbox_item_delegate.h"
+#include "instrumentation.h"
 #include "limits.h"
 #include <QDebug>
 #include <QAbstractItemView>
 #include <QSpinBox>
 #include <QLineEdit>
-#include <QSettings>
 
 // Function to be called from any other language. This assing to the provided column of the provided TableView a QSpinBoxItemDelegate.
 // We have to pass it the integer type (16, 32 or 64) too for later checks.
@@ -21,32 +21,23 @@ QSpinBoxItemDelegate::QSpinBoxItemDelegate(QObject *parent, const int integer_ty
     dark_theme = is_dark_theme_enabled;
     use_filter = has_filter;
     use_right_side_mark = right_side_mark;
-
-    QSettings* q_settings = new QSettings("FrodoWazEre", "rpfm");
-
-    if (dark_theme) {
-        colour_table_added = QColor(q_settings->value("colour_dark_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_dark_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_dark_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_dark_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_dark_diagnostic_info").toString());
-    } else {
-        colour_table_added = QColor(q_settings->value("colour_light_table_added").toString());
-        colour_table_modified = QColor(q_settings->value("colour_light_table_modified").toString());
-        colour_diagnostic_error = QColor(q_settings->value("colour_light_diagnostic_error").toString());
-        colour_diagnostic_warning = QColor(q_settings->value("colour_light_diagnostic_warning").toString());
-        colour_diagnostic_info = QColor(q_settings->value("colour_light_diagnostic_info").toString());
-    }
+    pool_editors = true;
 }
 
 // Function called when the widget it's created. Here we configure the spinbox/linedit.
 QWidget* QSpinBoxItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &, const QModelIndex &) const {
+    InstrumentationScope scope(InstrumentationProbe::DelegateCreateEditor);
 
     // Stop the diagnostics timer, so it doesn't steal the focus of the editor.
     if (diag_timer) {
         diag_timer->stop();
     }
 
+    // Editors of this delegate are all the same, so we reuse them if we can.
+    if (QWidget* editor = takePooledEditor(parent)) {
+        return editor;
+    }
+
     // SpinBoxes only support i16, i32, not i64, so for i64 we use a linedit with validation.
     if (type == 64) {
         QLineEdit* lineEdit = new QLineEdit(parent);
@@ -0,0 +1,246 @@
+#include "table_column_cache.h"
+#include "lazy_text_item.h"
+#include <QStandardItem>
+#include <QVariant>
+
+// Function to change the model this cache reads from. This drops everything cached.
+void TableColumnCache::setModel(const QAbstractItemModel *new_model) {
+    model = new_model;
+    standard_model = dynamic_cast<const QStandardItemModel*>(new_model);
+    invalidate();
+}
+
+// Function to get the data of a cell from the model, the same way its items would return it.
+QVariant TableColumnCache::cellData(int row, int column) const {
+    if (standard_model != nullptr) {
+        const QStandardItem *item = standard_model->item(row, column);
+        if (item == nullptr) {
+            return QVariant();
+        }
+
+        // Lazy texts are read skipping their cache, as we're going to read the entire column.
+        if (item->type() == LazyTextItem::Type) {
+            return QVariant(static_cast<const LazyTextItem*>(item)->displayText(false));
+        }
+
+        return item->data(2);
+    }
+
+    return model->index(row, column).data(Qt::EditRole);
+}
+
+// Function to get the check state of a cell from the model, as the cache stores it.
+qint8 TableColumnCache::cellCheckState(int row, int column) const {
+    if (standard_model != nullptr) {
+        const QStandardItem *item = standard_model->item(row, column);
+        if (item == nullptr || !item->isCheckable()) {
+            return -1;
+        }
+        return item->checkState() == Qt::CheckState::Checked ? 1 : 0;
+    }
+
+    QModelIndex index = model->index(row, column);
+    if (!(model->flags(index) & Qt::ItemIsUserCheckable)) {
+        return -1;
+    }
+    return index.data(Qt::CheckStateRole).toInt() == Qt::CheckState::Checked ? 1 : 0;
+}
+
+// Function to drop all the cached columns.
+void TableColumnCache::invalidate() {
+    columns.clear();
+}
+
+// Function to drop the cached data of a range of columns.
+void TableColumnCache::invalidateColumns(int first, int last) {
+    for (int column = qMax(0, first); column <= last && column < columns.count(); ++column) {
+        columns[column] = CachedColumn();
+    }
+}
+
+// Function to refresh a few changed cells in place. Big ranges just drop the affected columns, as reloading them later is cheaper.
+void TableColumnCache::updateCells(int first_row, int last_row, int first_column, int last_column) {
+    const bool in_place = last_row - first_row < 64;
+    for (int column = qMax(0, first_column); column <= last_column && column < columns.count(); ++column) {
+        CachedColumn &cached = columns[column];
+        if (!cached.has_text) {
+            continue;
+        }
+
+        if (!in_place || last_row >= cached.rowCount()) {
+            cached = CachedColumn();
+            continue;
+        }
+
+        for (int row = qMax(0, first_row); row <= last_row; ++row) {
+            updateCell(cached, row, column);
+        }
+    }
+}
+
+// Function to replace the cached data of a single cell with the current one from the model.
+void TableColumnCache::updateCell(CachedColumn &cached, int row, int column) {
+    QVariant data = cellData(row, column);
+    QString text = data.toString();
+
+    // If the type of the value changed, the typed values are no longer valid.
+    CachedColumnType type = CachedColumnType::Text;
+    if (data.userType() == QMetaType::Int || data.userType() == QMetaType::LongLong) {
+        type = CachedColumnType::Integer;
+    } else if (data.userType() == QMetaType::Float || data.userType() == QMetaType::Double) {
+        type = CachedColumnType::Float;
+    }
+
+    if (type != cached.type) {
+        cached.type = CachedColumnType::Text;
+        cached.has_numbers = false;
+        cached.integers.clear();
+        cached.floats.clear();
+    }
+
+    cached.check_state[row] = cellCheckState(row, column);
+
+    int start = cached.offsets.at(row);
+    int delta = text.count() - (cached.offsets.at(row + 1) - start);
+    cached.text.replace(start, cached.offsets.at(row + 1) - start, text);
+    for (int i = row + 1; i < cached.offsets.count(); ++i) {
+        cached.offsets[i] += delta;
+    }
+
+    if (cached.has_folded_text) {
+        QString folded = text.toCaseFolded();
+        int folded_start = cached.folded_offsets.at(row);
+        int folded_delta = folded.count() - (cached.folded_offsets.at(row + 1) - folded_start);
+        cached.folded_text.replace(folded_start, cached.folded_offsets.at(row + 1) - folded_start, folded);
+        for (int i = row + 1; i < cached.folded_offsets.count(); ++i) {
+            cached.folded_offsets[i] += folded_delta;
+        }
+    }
+
+    if (cached.has_numbers) {
+        if (cached.type == CachedColumnType::Integer) {
+            cached.integers[row] = data.toLongLong();
+        } else if (cached.type == CachedColumnType::Float) {
+            cached.floats[row] = data.toDouble();
+        }
+    }
+}
+
+// Function to know if a column is cached, which means it can be read from other threads.
+bool TableColumnCache::isLoaded(int column) const {
+    return column >= 0 && column < columns.count() && columns.at(column).has_text;
+}
+
+// Function to make sure we have a slot for every column of the model.
+void TableColumnCache::ensureColumns() {
+    int count = model != nullptr ? model->columnCount() : 0;
+    if (columns.count() != count) {
+        columns.resize(count);
+    }
+}
+
+// Function to get the texts and check states of a column, loading them if needed.
+const CachedColumn &TableColumnCache::textColumn(int column) {
+    ensureColumns();
+
+    CachedColumn &cached = columns[column];
+    if (cached.has_text) {
+        return cached;
+    }
+
+    const int rows = model->rowCount();
+    cached.offsets.resize(rows + 1);
+    cached.check_state.resize(rows);
+    cached.integers.clear();
+    cached.floats.clear();
+
+    // We guess the type from the variants, and keep it only if all the cells agree on it.
+    bool first = true;
+    for (int row = 0; row < rows; ++row) {
+        cached.offsets[row] = cached.text.count();
+
+        // Missing items give an invalid variant, which makes the column a text one.
+        cached.check_state[row] = cellCheckState(row, column);
+
+        QVariant data = cellData(row, column);
+        cached.text.append(data.toString());
+
+        CachedColumnType type;
+        switch (data.userType()) {
+            case QMetaType::Int:
+            case QMetaType::LongLong:
+                type = CachedColumnType::Integer;
+                break;
+            case QMetaType::Float:
+            case QMetaType::Double:
+                type = CachedColumnType::Float;
+                break;
+            default:
+                type = CachedColumnType::Text;
+                break;
+        }
+
+        if (first) {
+            cached.type = type;
+            first = false;
+        } else if (cached.type != type) {
+            cached.type = CachedColumnType::Text;
+        }
+    }
+
+    cached.offsets[rows] = cached.text.count();
+    cached.has_text = true;
+    return cached;
+}
+
+// Function to get the case-folded texts of a column, loading them if needed.
+//
+// Folding can change the length of a cell, so the folded buffer has its own offsets.
+const CachedColumn &TableColumnCache::foldedColumn(int column) {
+    textColumn(column);
+
+    CachedColumn &cached = columns[column];
+    if (cached.has_folded_text) {
+        return cached;
+    }
+
+    const int rows = cached.rowCount();
+    cached.folded_text.reserve(cached.text.count());
+    cached.folded_offsets.resize(rows + 1);
+    for (int row = 0; row < rows; ++row) {
+        cached.folded_offsets[row] = cached.folded_text.count();
+        cached.folded_text.append(cached.cell(row).toString().toCaseFolded());
+    }
+
+    cached.folded_offsets[rows] = cached.folded_text.count();
+    cached.has_folded_text = true;
+    return cached;
+}
+
+// Function to get the typed values of a numeric column, loading them if needed. Text columns get no values.
+const CachedColumn &TableColumnCache::numericColumn(int column) {
+    textColumn(column);
+
+    CachedColumn &cached = columns[column];
+    if (cached.has_numbers) {
+        return cached;
+    }
+
+    const int rows = cached.rowCount();
+    if (cached.type == CachedColumnType::Integer) {
+        cached.integers.resize(rows);
+        for (int row = 0; row < rows; ++row) {
+            cached.integers[row] = cellData(row, column).toLongLong();
+        }
+    }
+
+    else if (cached.type == CachedColumnType::Float) {
+        cached.floats.resize(rows);
+        for (int row = 0; row < rows; ++row) {
+            cached.floats[row] = cellData(row, column).toDouble();
+        }
+    }
+
+    cached.has_numbers = true;
+    return cached;
+}
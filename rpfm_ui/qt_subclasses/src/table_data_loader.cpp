@@ -0,0 +1,205 @@
+#include "table_data_loader.h"
+#include "cell_status.h"
+#include "lazy_text_item.h"
+#include <QStandardItem>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QStandardItemModel>
+#include <QStringList>
+#include <QVector>
+#include <cstring>
+
+// Function to load an entire table from a packed buffer, from Rust. See TableDataLoader for the format of the buffer.
+extern "C" void load_table_data(QAbstractItemModel *model, const char *buffer, qint64 buffer_size, int rows, QList<int> column_types, QList<int> key_columns, bool editable, QString *tooltip_template, QString *sequence_text) {
+    TableDataLoader loader(buffer, buffer_size, column_types);
+    loader.loadInto(
+        model,
+        rows,
+        key_columns,
+        editable,
+        tooltip_template != nullptr ? *tooltip_template : QString(),
+        sequence_text != nullptr ? *sequence_text : QString()
+    );
+}
+
+// Function to format a float the shortest way that still reads back as the same float, without exponents. This is how Rust displays them.
+static QString formatFloat(float value) {
+    for (int decimals = 0; decimals < 10; ++decimals) {
+        QString text = QString::number(static_cast<double>(value), 'f', decimals);
+        if (text.toFloat() == value) {
+            return text;
+        }
+    }
+
+    return QString::number(static_cast<double>(value), 'g', 9);
+}
+
+// Constructor of TableDataLoader.
+TableDataLoader::TableDataLoader(const char *buffer, qint64 buffer_size, const QList<int> &column_types):
+    buffer(buffer),
+    buffer_size(buffer != nullptr ? buffer_size : 0),
+    column_types(column_types) {}
+
+// Function to read a fixed-size value from the buffer. Once the buffer runs out, everything reads as 0.
+template <typename T> T TableDataLoader::read() {
+    T value = T();
+    if (truncated || position + static_cast<qint64>(sizeof(T)) > buffer_size) {
+        truncated = true;
+        return value;
+    }
+
+    std::memcpy(&value, buffer + position, sizeof(T));
+    position += sizeof(T);
+    return value;
+}
+
+// Function to read a length-prefixed UTF-8 text from the buffer.
+QString TableDataLoader::readText() {
+    quint32 length = read<quint32>();
+    if (truncated || position + static_cast<qint64>(length) > buffer_size) {
+        truncated = true;
+        return QString();
+    }
+
+    QString text = QString::fromUtf8(buffer + position, static_cast<int>(length));
+    position += length;
+    return text;
+}
+
+// Function to skip a length-prefixed UTF-8 text from the buffer, returning the offset of its length, or -1 if the buffer ran out.
+qint64 TableDataLoader::skipText() {
+    const qint64 offset = position;
+    quint32 length = read<quint32>();
+    if (truncated || position + static_cast<qint64>(length) > buffer_size) {
+        truncated = true;
+        return -1;
+    }
+
+    position += length;
+    return offset;
+}
+
+// Function to load the buffer into a model, replacing whatever it had.
+void TableDataLoader::loadInto(QAbstractItemModel *model, int rows, const QList<int> &key_columns, bool editable, const QString &tooltip_template, const QString &sequence_text) {
+    if (QStandardItemModel *standard_model = dynamic_cast<QStandardItemModel*>(model)) {
+        loadIntoStandardModel(standard_model, rows, key_columns, editable, tooltip_template, sequence_text);
+    }
+}
+
+// Function to load the buffer into a QStandardItemModel, appending the rows to it.
+//
+// Signals are blocked for all rows but the last one, so the views only get notified once, instead of once per row.
+//
+// Text cells are not decoded here. They become LazyTextItems pointing to their text in a copy of the buffer, and only the texts
+// something asks for get decoded. This keeps the open time and memory of big tables closer to what's visible.
+void TableDataLoader::loadIntoStandardModel(QStandardItemModel *model, int rows, const QList<int> &key_columns, bool editable, const QString &tooltip_template, const QString &sequence_text) {
+    const int columns = column_types.count();
+    QSharedPointer<const LazyTextBuffer> texts(new LazyTextBuffer(QByteArray(buffer, static_cast<int>(buffer_size)), tooltip_template));
+    QVector<bool> is_key(columns, false);
+    for (int column: key_columns) {
+        if (column >= 0 && column < columns) {
+            is_key[column] = true;
+        }
+    }
+
+    const bool was_blocked = model->blockSignals(true);
+    for (int row = 0; row < rows; ++row) {
+        QList<QStandardItem*> items;
+        items.reserve(columns);
+
+        for (int column = 0; column < columns; ++column) {
+            QStandardItem *item = nullptr;
+            switch (static_cast<TableColumnType>(column_types.at(column))) {
+
+                // Booleans are checkable instead of editable.
+                case TableColumnType::Boolean: {
+                    bool value = read<quint8>() != 0;
+                    item = new QStandardItem();
+                    item->setData(QVariant(true), 30);
+                    item->setData(QVariant(false), 35);
+                    item->setData(QVariant(value), 31);
+                    item->setToolTip(tooltip_template.arg(value ? QStringLiteral("true") : QStringLiteral("false")));
+                    item->setEditable(false);
+                    item->setCheckable(true);
+                    item->setCheckState(value ? Qt::CheckState::Checked : Qt::CheckState::Unchecked);
+                    break;
+                }
+
+                case TableColumnType::Integer: {
+                    qint32 value = read<qint32>();
+                    item = new QStandardItem();
+                    item->setToolTip(tooltip_template.arg(QString::number(value)));
+                    item->setData(QVariant(true), 30);
+                    item->setData(QVariant(false), 35);
+                    item->setData(QVariant(value), 31);
+                    item->setData(QVariant(value), 2);
+                    break;
+                }
+
+                case TableColumnType::Integer64: {
+                    qint64 value = read<qint64>();
+                    item = new QStandardItem();
+                    item->setToolTip(tooltip_template.arg(QString::number(value)));
+                    item->setData(QVariant(true), 30);
+                    item->setData(QVariant(false), 35);
+                    item->setData(QVariant(value), 31);
+                    item->setData(QVariant(value), 2);
+                    break;
+                }
+
+                case TableColumnType::Float: {
+                    float value = read<float>();
+                    item = new QStandardItem();
+                    item->setToolTip(tooltip_template.arg(formatFloat(value)));
+                    item->setData(QVariant(true), 30);
+                    item->setData(QVariant(false), 35);
+                    item->setData(QVariant(value), 31);
+                    item->setData(QVariant(value), 2);
+                    break;
+                }
+
+                // The text, its source value and its tooltip come from the buffer.
+                case TableColumnType::Text: {
+                    item = new LazyTextItem(texts, skipText());
+                    item->setData(QVariant(true), 30);
+                    item->setData(QVariant(false), 35);
+                    break;
+                }
+
+                // Sequences are edited on their own view, so here they only show a placeholder.
+                case TableColumnType::Sequence: {
+                    QString value = readText();
+                    item = new QStandardItem(sequence_text);
+                    item->setEditable(false);
+                    item->setData(QVariant(false), 30);
+                    item->setData(QVariant(true), 35);
+                    item->setData(QVariant(value), 36);
+                    break;
+                }
+            }
+
+            if (item == nullptr) {
+                item = new QStandardItem();
+            }
+
+            if (is_key.at(column)) {
+                item->setData(QVariant(true), 20);
+                item->setData(QVariant(static_cast<uint>(CELL_STATUS_KEY)), CELL_STATUS_ROLE);
+            }
+
+            if (!editable) {
+                item->setEditable(false);
+            }
+
+            items.append(item);
+        }
+
+        if (row == rows - 1) {
+            model->blockSignals(was_blocked);
+        }
+
+        model->appendRow(items);
+    }
+
+    model->blockSignals(was_blocked);
+}
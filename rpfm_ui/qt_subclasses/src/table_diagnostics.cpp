@@ -0,0 +1,241 @@
+#include "table_diagnostics.h"
+#include <algorithm>
+
+// Function to apply diagnostics to a table model from Rust.
+//
+// The cells come as (row, column, flags) triplets, with the flags being CELL_STATUS_ERROR/WARNING/INFO bits. A row of -1 means
+// the entire column, and a column of -1 the entire row. Flags of the same cell are merged. If replace is set, cells not in the list
+// get their diagnostics cleared. Otherwise, the list gets added to what was already painted.
+extern "C" void apply_table_diagnostics(QAbstractItemModel* model, const qint32* cells, int count, bool replace) {
+    if (model == nullptr) {
+        return;
+    }
+
+    const int rows = model->rowCount();
+    const int columns = model->columnCount();
+    QHash<quint64, quint8> new_cells;
+    for (int index = 0; cells != nullptr && index < count; ++index) {
+        int row = cells[index * 3];
+        int column = cells[index * 3 + 1];
+        quint8 flags = static_cast<quint8>(cells[index * 3 + 2]) & CELL_STATUS_DIAGNOSTICS;
+        if (flags == 0 || row >= rows || column >= columns || (row == -1 && column == -1)) {
+            continue;
+        }
+
+        // At this point, is possible the row is no longer valid, so we skip anything out of the table.
+        int first_row = row == -1 ? 0 : row;
+        int last_row = row == -1 ? rows - 1 : row;
+        int first_column = column == -1 ? 0 : column;
+        int last_column = column == -1 ? columns - 1 : column;
+        if (first_row < 0 || first_column < 0) {
+            continue;
+        }
+
+        for (int cell_row = first_row; cell_row <= last_row; ++cell_row) {
+            for (int cell_column = first_column; cell_column <= last_column; ++cell_column) {
+                new_cells[(static_cast<quint64>(cell_row) << 32) | static_cast<quint32>(cell_column)] |= flags;
+            }
+        }
+    }
+
+    TableDiagnostics::forModel(model)->apply(new_cells, replace);
+}
+
+// Constructor of TableDiagnostics. Any change of rows or columns makes the record useless, as the cells move.
+TableDiagnostics::TableDiagnostics(QAbstractItemModel* model): QObject(model), model(model) {
+    connect(model, &QAbstractItemModel::rowsInserted, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::rowsMoved, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::columnsInserted, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::columnsRemoved, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::columnsMoved, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::modelReset, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::layoutChanged, this, &TableDiagnostics::invalidate);
+    connect(model, &QAbstractItemModel::dataChanged, this, &TableDiagnostics::sourceDataChanged);
+}
+
+// Function to get the record of a model, creating it if it doesn't have one yet.
+TableDiagnostics* TableDiagnostics::forModel(QAbstractItemModel* model) {
+    TableDiagnostics* diagnostics = model->findChild<TableDiagnostics*>(QString(), Qt::FindDirectChildrenOnly);
+    if (diagnostics == nullptr) {
+        diagnostics = new TableDiagnostics(model);
+    }
+
+    return diagnostics;
+}
+
+// Function to apply new diagnostics, writing only the cells that change.
+void TableDiagnostics::apply(const QHash<quint64, quint8> &cells, bool replace) {
+    if (!painted_valid) {
+        rebuild();
+    }
+
+    // Get the cells that change, and their new flags.
+    QHash<quint64, quint8> target = cells;
+    if (!replace) {
+        for (auto iter = painted.constBegin(); iter != painted.constEnd(); ++iter) {
+            target[iter.key()] |= iter.value();
+        }
+    }
+
+    QVector<quint64> changed;
+    for (auto iter = target.constBegin(); iter != target.constEnd(); ++iter) {
+        if (painted.value(iter.key(), 0) != iter.value()) {
+            changed.append(iter.key());
+        }
+    }
+
+    for (auto iter = painted.constBegin(); iter != painted.constEnd(); ++iter) {
+        if (!target.contains(iter.key())) {
+            changed.append(iter.key());
+        }
+    }
+
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    // Write them without signals, so the views don't get one update per cell.
+    applying = true;
+    const bool was_blocked = model->blockSignals(true);
+    for (quint64 key: changed) {
+        int row = static_cast<int>(key >> 32);
+        int column = static_cast<int>(key & 0xFFFFFFFF);
+        setCellFlags(row, column, target.value(key, 0));
+    }
+    model->blockSignals(was_blocked);
+
+    target.squeeze();
+    painted = target;
+    emitChanged(changed);
+    applying = false;
+}
+
+// Function to forget the record. It gets rebuilt from the model the next time it's needed.
+void TableDiagnostics::invalidate() {
+    painted.clear();
+    painted_valid = false;
+}
+
+// Function to rebuild the record reading the entire model.
+void TableDiagnostics::rebuild() {
+    painted.clear();
+    const int rows = model->rowCount();
+    const int columns = model->columnCount();
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            quint8 flags = cellFlags(row, column);
+            if (flags != 0) {
+                painted.insert(cellKey(row, column), flags);
+            }
+        }
+    }
+
+    painted_valid = true;
+}
+
+// Function to get the diagnostic bits of a cell, from its packed status.
+quint8 TableDiagnostics::cellFlags(int row, int column) const {
+    return cell_status(model->index(row, column)) & CELL_STATUS_DIAGNOSTICS;
+}
+
+// Function to write the diagnostic bits of a cell that changed, keeping the rest of its packed status.
+void TableDiagnostics::setCellFlags(int row, int column, quint8 new_flags) {
+    QModelIndex index = model->index(row, column);
+    if (!index.isValid()) {
+        return;
+    }
+
+    const quint8 status = (cell_status(index) & ~CELL_STATUS_DIAGNOSTICS) | new_flags;
+    model->setData(index, QVariant(static_cast<uint>(status)), CELL_STATUS_ROLE);
+}
+
+// Function to notify the views of the changed cells, with one dataChanged per block.
+//
+// Cells get grouped in runs of contiguous columns within a row, and runs covering the same columns in consecutive rows get merged.
+void TableDiagnostics::emitChanged(QVector<quint64> &changed) {
+    std::sort(changed.begin(), changed.end());
+    const QVector<int> roles({CELL_STATUS_ROLE});
+
+    struct Block {
+        int first_row;
+        int last_row;
+        int first_column;
+        int last_column;
+    };
+
+    // Runs of each row. Keys sort by row, then column, so runs come out in order.
+    QVector<Block> runs;
+    for (quint64 key: changed) {
+        int row = static_cast<int>(key >> 32);
+        int column = static_cast<int>(key & 0xFFFFFFFF);
+        if (!runs.isEmpty() && runs.last().first_row == row && runs.last().last_column == column - 1) {
+            runs.last().last_column = column;
+        } else {
+            runs.append({row, row, column, column});
+        }
+    }
+
+    // Blocks ending in the previous row, and blocks already extended to the current one.
+    QVector<Block> blocks;
+    QVector<Block> open_blocks;
+    QVector<Block> extended_blocks;
+    int current_row = -1;
+    for (const Block &run: runs) {
+        if (run.first_row != current_row) {
+
+            // Blocks the previous row didn't extend are done. The ones it did can only go on if this row comes right after it.
+            blocks << open_blocks;
+            open_blocks = extended_blocks;
+            extended_blocks.clear();
+            if (run.first_row != current_row + 1) {
+                blocks << open_blocks;
+                open_blocks.clear();
+            }
+
+            current_row = run.first_row;
+        }
+
+        bool extended = false;
+        for (int index = 0; index < open_blocks.count(); ++index) {
+            if (open_blocks.at(index).first_column == run.first_column && open_blocks.at(index).last_column == run.last_column) {
+                Block block = open_blocks.takeAt(index);
+                block.last_row = run.first_row;
+                extended_blocks.append(block);
+                extended = true;
+                break;
+            }
+        }
+
+        if (!extended) {
+            extended_blocks.append(run);
+        }
+    }
+
+    blocks << open_blocks << extended_blocks;
+    for (const Block &block: blocks) {
+        emit model->dataChanged(model->index(block.first_row, block.first_column), model->index(block.last_row, block.last_column), roles);
+    }
+}
+
+// Function called when data changes in the model. If the packed status changed outside of apply, the record of those cells gets re-read.
+void TableDiagnostics::sourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles) {
+    if (applying || !painted_valid || top_left.parent().isValid()) {
+        return;
+    }
+
+    if (!roles.isEmpty() && !roles.contains(CELL_STATUS_ROLE)) {
+        return;
+    }
+
+    for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+        for (int column = top_left.column(); column <= bottom_right.column(); ++column) {
+            quint8 flags = cellFlags(row, column);
+            if (flags != 0) {
+                painted.insert(cellKey(row, column), flags);
+            } else {
+                painted.remove(cellKey(row, column));
+            }
+        }
+    }
+}
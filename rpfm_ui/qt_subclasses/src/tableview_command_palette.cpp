@@ -6,6 +6,27 @@ extern "C" QTableView* new_tableview_command_palette() {
     return dynamic_cast<QTableView*>(tableview);
 }
 
+// Function to set the candidates the palette matches against, from Rust. This is the slow part, so it should only be done when they change.
+extern "C" void tableview_command_palette_set_candidates(QTableView* palette, QStringList* candidates) {
+    QTableViewCommandPalette* palette2 = dynamic_cast<QTableViewCommandPalette*>(palette);
+    if (palette2 != nullptr) {
+        palette2->matcher.setCandidates(candidates != nullptr ? *candidates : QStringList());
+    }
+}
+
+// Function to get, from Rust, the indexes of the best candidates for a query, best first.
+extern "C" void tableview_command_palette_match(QTableView* palette, QString* query, int limit, QList<int>* results) {
+    QTableViewCommandPalette* palette2 = dynamic_cast<QTableViewCommandPalette*>(palette);
+    if (palette2 == nullptr || results == nullptr) {
+        return;
+    }
+
+    results->clear();
+    for (const FuzzyMatch &match: palette2->matcher.match(query != nullptr ? *query : QString(), limit)) {
+        results->append(match.index);
+    }
+}
+
 QTableViewCommandPalette::QTableViewCommandPalette(): QTableView() {}
 
 int QTableViewCommandPalette::sizeHintForRow(int) const {
@@ -1,9 +1,18 @@
 #include "tableview_filter.h"
+#include "instrumentation.h"
+#include "literal_matcher.h"
+#include "parallel_for.h"
 #include <QSortFilterProxyModel>
 #include <QItemSelection>
 #include <QRegularExpression>
 #include <QStandardItem>
 #include <QStandardItemModel>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QRunnable>
+#include <QThreadPool>
+#include <algorithm>
+#include <iterator>
 
 // Function to create the filter in a way that we don't need to bother Rust with new types.
 extern "C" QSortFilterProxyModel* new_tableview_filter(QObject *parent) {
@@ -20,116 +29,745 @@ extern "C" void trigger_tableview_filter(
     QList<int> show_blank_cells,
     QList<int> match_groups_per_column
 ) {
+    InstrumentationScope scope(InstrumentationProbe::TriggerTableFilter);
     QTableViewSortFilterProxyModel* filter2 = static_cast<QTableViewSortFilterProxyModel*>(filter);
     filter2->columns = columns;
     filter2->patterns = patterns;
     filter2->case_sensitive = case_sensitive;
     filter2->show_blank_cells = show_blank_cells;
     filter2->match_groups_per_column = match_groups_per_column;
-    filter2->setFilterKeyColumn(0);
+    filter2->scheduleFilterPlan(FilterPlan::build(columns, patterns, case_sensitive, show_blank_cells, match_groups_per_column));
 }
 
-// Constructor of QTableViewSortFilterProxyModel.
-QTableViewSortFilterProxyModel::QTableViewSortFilterProxyModel(QObject *parent): QSortFilterProxyModel(parent) {}
+// Function to enable/disable the trigram index of the filter from Rust. Meant for big tables, where the same columns get filtered
+// by literals again and again.
+extern "C" void set_tableview_filter_trigram_index(QSortFilterProxyModel* filter, bool enabled) {
+    QTableViewSortFilterProxyModel* filter2 = static_cast<QTableViewSortFilterProxyModel*>(filter);
+    filter2->setTrigramIndexEnabled(enabled);
+}
 
-// Function called when the filter changes.
-bool QTableViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+// Runnable to build the trigram index of a column in the background. Once done, the index is sent back to the proxy
+// from the GUI thread, if the proxy still exists.
+class TrigramIndexTask : public QRunnable {
 
-    // First, split the matches in groups.
-    QVector<QVector<int>> matches_per_group = QVector<QVector<int>>();
+public:
+    TrigramIndexTask(QTableViewSortFilterProxyModel *proxy, int column, int generation, const QString &text, const QVector<int> &offsets):
+        proxy(proxy), column(column), generation(generation), text(text), offsets(offsets) {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        QSharedPointer<const TrigramIndex> index(new TrigramIndex(TrigramIndex::build(text, offsets)));
+        QPointer<QTableViewSortFilterProxyModel> target = proxy;
+        int target_column = column;
+        int target_generation = generation;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [target, target_column, target_generation, index]() {
+            if (!target.isNull()) {
+                target->installTrigramIndex(target_column, target_generation, index);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QPointer<QTableViewSortFilterProxyModel> proxy;
+    int column;
+    int generation;
+    QString text;
+    QVector<int> offsets;
+};
+
+// Runnable to run a filter plan over a big table in the background. It works over its own copy of the cache, so the GUI thread
+// can keep changing it meanwhile. Once done, the results are sent back to the proxy from the GUI thread, if the pass was not cancelled.
+//
+// If candidates are provided, only those rows are checked. The rest are rejected.
+class FilterPassTask : public QRunnable {
+
+public:
+    FilterPassTask(QTableViewSortFilterProxyModel *proxy, int generation, int revision, const FilterPlan &plan, const TableColumnCache &cache, int rows, const QVector<int> &candidates, bool use_candidates, const FilterCancelToken &token):
+        proxy(proxy), generation(generation), revision(revision), plan(plan), cache(cache), rows(rows), candidates(candidates), use_candidates(use_candidates), token(token) {
+        setAutoDelete(true);
+    }
+
+    void run() override {
+        InstrumentationScope scope(InstrumentationProbe::TableFilterWorker);
+        QVector<quint8> results(rows, 0);
+        quint8* results_data = results.data();
+        const int count = use_candidates ? candidates.count() : rows;
+        const int* candidates_data = candidates.constData();
+        const bool check_candidates = use_candidates;
+        const int max_rows = rows;
+        const FilterPlan &current_plan = plan;
+        const TableColumnCache &current_cache = cache;
+        const FilterCancelToken &current_token = token;
+
+        // Chunks check the token every few rows, so a cancelled pass stops soon.
+        parallel_for(count, 1024, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if ((i - begin) % 256 == 0 && current_token.isCancelled()) {
+                    return;
+                }
+
+                int row = check_candidates ? candidates_data[i] : i;
+                if (row < max_rows) {
+                    results_data[row] = current_plan.acceptsRow(row, current_cache) ? 1 : 0;
+                }
+            }
+        });
+
+        if (token.isCancelled()) {
+            return;
+        }
+
+        QVector<int> row_list;
+        for (int row = 0; row < rows; ++row) {
+            if (results_data[row] == 1) {
+                row_list.append(row);
+            }
+        }
+
+        QPointer<QTableViewSortFilterProxyModel> target = proxy;
+        int target_generation = generation;
+        int target_revision = revision;
+        FilterPlan pass_plan = plan;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [target, target_generation, target_revision, pass_plan, results, row_list]() {
+            if (!target.isNull()) {
+                target->installFilterPass(target_generation, target_revision, pass_plan, results, row_list);
+            }
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    QPointer<QTableViewSortFilterProxyModel> proxy;
+    int generation;
+    int revision;
+    FilterPlan plan;
+    TableColumnCache cache;
+    int rows;
+    QVector<int> candidates;
+    bool use_candidates;
+    FilterCancelToken token;
+};
+
+// Function to check if a pattern has no regex metacharacters, so it matches just as a plain substring.
+static bool isLiteralPattern(const QString &pattern) {
+    static const QString metacharacters = QStringLiteral("\\^$.|?*+()[]{}");
+    for (const QChar &character: pattern) {
+        if (metacharacters.contains(character)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Function to check if a filter on a cell can only reject things the previous one on the same cell already rejected.
+//
+// That's only true for literals extending the previous literal. For checkboxes, the new pattern cannot accept
+// states the previous one didn't accept.
+bool FilterMatch::narrows(const FilterMatch &previous) const {
+    if (column != previous.column ||
+        case_sensitivity != previous.case_sensitivity ||
+        show_blank_cells != previous.show_blank_cells ||
+        !is_literal || !previous.is_literal ||
+        !use_regex || !previous.use_regex) {
+        return false;
+    }
+
+    if (previous.check_state != FilterCheckState::Any && check_state != previous.check_state) {
+        return false;
+    }
+
+    if (case_sensitivity == Qt::CaseSensitivity::CaseSensitive) {
+        return pattern.contains(previous.pattern);
+    } else {
+        return pattern.toCaseFolded().contains(previous.pattern.toCaseFolded());
+    }
+}
+
+// Function to check if this plan only narrows the previous one, which means every row it accepts was accepted by the previous one.
+bool FilterPlan::narrows(const FilterPlan &previous) const {
+    if (accepts_all || previous.accepts_all || groups.count() != previous.groups.count()) {
+        return false;
+    }
+
+    for (int i = 0; i < groups.count(); ++i) {
+        const QVector<FilterMatch> &group = groups.at(i);
+        const QVector<FilterMatch> &previous_group = previous.groups.at(i);
+        if (group.count() != previous_group.count()) {
+            return false;
+        }
+
+        for (int j = 0; j < group.count(); ++j) {
+            if (!group.at(j).narrows(previous_group.at(j))) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Function to build the filter plan. This resolves the groups, compiles the regexes and classifies the checkbox cases once,
+// so the per-row filtering doesn't need to do it every time.
+FilterPlan FilterPlan::build(
+    const QList<int> &columns,
+    const QStringList &patterns,
+    const QList<int> &case_sensitive,
+    const QList<int> &show_blank_cells,
+    const QList<int> &match_groups_per_column
+) {
+    FilterPlan plan;
+    if (match_groups_per_column.isEmpty()) {
+        return plan;
+    }
 
     // Initialize the groups so it doesn't explode later.
     const int max_groups = *std::max_element(match_groups_per_column.begin(), match_groups_per_column.end()) + 1;
-    for (int i = 0; i < max_groups; ++i) {
-        matches_per_group.append(QVector<int>());
-    }
+    plan.groups.resize(max_groups);
 
-    // Split matches per groups.
+    // Split matches per groups, compiling them in the process.
     for (int i = 0; i < match_groups_per_column.count(); ++i) {
-        int group = match_groups_per_column.at(i);
+        FilterMatch match;
+        match.column = columns.at(i);
+        match.pattern = patterns.at(i);
+        match.case_sensitivity = static_cast<Qt::CaseSensitivity>(case_sensitive.at(i));
+        match.show_blank_cells = show_blank_cells.at(i) == 1;
 
-        if (!matches_per_group[group].contains(i)) {
-            matches_per_group[group].append(i);
+        QString pattern_lower = match.pattern.toLower();
+        if (pattern_lower == "true" || pattern_lower == "1") {
+            match.check_state = FilterCheckState::Checked;
+        } else if (pattern_lower == "false" || pattern_lower == "0") {
+            match.check_state = FilterCheckState::Unchecked;
+        } else {
+            match.check_state = FilterCheckState::Any;
+        }
+
+        QRegularExpression::PatternOptions options = QRegularExpression::PatternOptions();
+        if (match.case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+            options |= QRegularExpression::CaseInsensitiveOption;
+        }
+
+        match.is_literal = isLiteralPattern(match.pattern);
+        match.regex = QRegularExpression(match.pattern, options);
+        match.use_regex = match.regex.isValid();
+
+        // Literals don't need the regex engine. Case insensitive ones are searched, already folded, over the folded texts.
+        match.use_literal_search = match.is_literal && match.use_regex;
+        if (match.use_literal_search && match.case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+            match.folded_pattern = match.pattern.toCaseFolded();
+        }
+
+        if (match.use_regex && !match.use_literal_search) {
+            match.regex.optimize();
         }
+
+        plan.groups[match_groups_per_column.at(i)].append(match);
     }
 
-    // Logic for groups:
-    // - For a group to be valid, all matches on it must be valid (if one of them is not valid, the entire group is invalid).
-    // - For a row to be valid, one of the group needs to be valid (we keep trying until we find a valid one).
-    // This means we have to check one group at a time, and if one of them is valid, the full row is valid.
-    for (int j = 0; j < max_groups; ++j) {
-        bool is_group_valid = true;
+    // An empty group is always valid, so in that case there is nothing to filter.
+    plan.accepts_all = false;
+    for (const QVector<FilterMatch> &group: plan.groups) {
+        if (group.isEmpty()) {
+            plan.accepts_all = true;
+            break;
+        }
+    }
+
+    return plan;
+}
 
-        // For each column, check if it's on the current group.
-        for (int match: matches_per_group.at(j)) {
-            int column = columns.at(match);
-            QString const pattern = patterns.at(match);
-            Qt::CaseSensitivity case_sensitivity = static_cast<Qt::CaseSensitivity>(case_sensitive.at(match));
-            bool show_blank_cells_in_column = show_blank_cells.at(match) == 1 ? true: false;
+// Function to check if a cell passes this match. The folded text is only used by case insensitive literals.
+bool FilterMatch::accepts(qint8 cell_check_state, const QStringRef &text, const QStringRef &folded_text) const {
 
-            QRegularExpression::PatternOptions options = QRegularExpression::PatternOptions();
-            if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
-                options |= QRegularExpression::CaseInsensitiveOption;
+    // Checkbox matches.
+    if (cell_check_state != -1) {
+        bool isChecked = cell_check_state == 1;
+        return !((check_state == FilterCheckState::Checked && !isChecked) || (check_state == FilterCheckState::Unchecked && isChecked));
+    }
+
+    // In case of text, if it's empty we let it pass the filters.
+    if (show_blank_cells && text.isEmpty()) {
+        return true;
+    }
+
+    // Text matches.
+    if (use_literal_search) {
+        if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+            if (folded_text.isNull()) {
+                const QString folded = text.toString().toCaseFolded();
+                return literal_contains(folded.utf16(), folded.count(), folded_pattern.utf16(), folded_pattern.count());
             }
 
-            QRegularExpression regex(pattern, options);
-            QModelIndex currntIndex = sourceModel()->index(source_row, column, source_parent);
-            QStandardItem *currntData = static_cast<QStandardItemModel*>(sourceModel())->itemFromIndex(currntIndex);
-            if (currntIndex.isValid()) {
-
-                // Checkbox matches.
-                if (currntData->isCheckable()) {
-                    QString pattern_lower = pattern.toLower();
-                    bool isChecked = currntData->checkState() == Qt::CheckState::Checked;
-                    if ((pattern_lower == "true" || pattern_lower == "1") && !isChecked) {
-                        is_group_valid = false;
-                        break;
-                    } else if ((pattern_lower == "false" || pattern_lower == "0") && isChecked) {
-                        is_group_valid = false;
-                        break;
-                    }
-                }
+            return literal_contains(folded_text.utf16(), folded_text.count(), folded_pattern.utf16(), folded_pattern.count());
+        } else {
+            return literal_contains(text.utf16(), text.count(), pattern.utf16(), pattern.count());
+        }
+    } else if (use_regex) {
+        return regex.match(text).hasMatch();
+    } else {
+        return text.contains(pattern);
+    }
+}
 
-                // In case of text, if it's empty we let it pass the filters.
-                else if (show_blank_cells_in_column && currntIndex.data(2).toString().isEmpty()) {
-                    continue;
-                }
+// Function to know if this match needs the case-folded texts of its column.
+bool FilterMatch::needsFoldedText() const {
+    return use_literal_search && case_sensitivity == Qt::CaseSensitivity::CaseInsensitive;
+}
 
-                // Text matches.
-                else if (regex.isValid()) {
-                    QRegularExpressionMatch match = regex.match(currntIndex.data(2).toString());
-                    if (!match.hasMatch()) {
-                        is_group_valid = false;
-                        break;
-                    }
-                }
-                else {
-                    if (!currntIndex.data(2).toString().contains(pattern)) {
-                        is_group_valid = false;
-                        break;
-                    }
+// Function to load in the cache the columns the plan needs. This has to run on the GUI thread.
+void FilterPlan::loadColumns(TableColumnCache &cache) const {
+    for (const QVector<FilterMatch> &group: groups) {
+        for (const FilterMatch &match: group) {
+            if (match.column >= 0 && match.column < cache.columnCount()) {
+                if (match.needsFoldedText()) {
+                    cache.foldedColumn(match.column);
+                } else {
+                    cache.textColumn(match.column);
                 }
             }
         }
+    }
+}
+
+// Function to run the plan against a row of the cache. Columns not in the cache are ignored, like invalid indexes.
+bool FilterPlan::acceptsRow(int row, const TableColumnCache &cache) const {
+    if (accepts_all) {
+        return true;
+    }
+
+    // One group at a time. If one of them is valid, the full row is valid.
+    for (const QVector<FilterMatch> &group: groups) {
+        bool is_group_valid = true;
+
+        for (const FilterMatch &match: group) {
+            if (!cache.isLoaded(match.column) || row >= cache.at(match.column).rowCount()) {
+                continue;
+            }
+
+            const CachedColumn &column = cache.at(match.column);
+            const QStringRef folded_text = match.needsFoldedText() && column.has_folded_text ? column.foldedCell(row) : QStringRef();
+            if (!match.accepts(column.check_state.at(row), column.cell(row), folded_text)) {
+                is_group_valid = false;
+                break;
+            }
+        }
 
         if (is_group_valid) {
-            return is_group_valid;
+            return true;
         }
     }
 
     return false;
 }
 
+// Function to get the check state of a cell, as the filter expects it.
+static qint8 filterCheckState(const QModelIndex &index) {
+    if (!(index.flags() & Qt::ItemIsUserCheckable)) {
+        return -1;
+    }
+
+    return index.data(Qt::CheckStateRole).toInt() == Qt::CheckState::Checked ? 1 : 0;
+}
+
+// Function to know if a change on these roles can change what the filter or the sorting see.
+static bool affectsDisplayData(const QVector<int> &roles) {
+    return roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(Qt::EditRole) || roles.contains(Qt::CheckStateRole);
+}
+
+// Constructor of QTableViewSortFilterProxyModel.
+QTableViewSortFilterProxyModel::QTableViewSortFilterProxyModel(QObject *parent): QSortFilterProxyModel(parent) {
+    scheduler = new FilterScheduler(this);
+}
+
+// Function to set the source model. We connect to it before the base class does so the cache and the parallel pass
+// results are updated before the base class re-filters or re-sorts the changed rows.
+void QTableViewSortFilterProxyModel::setSourceModel(QAbstractItemModel *source_model) {
+    for (const QMetaObject::Connection &connection: source_connections) {
+        disconnect(connection);
+    }
+    source_connections.clear();
+
+    // Whatever pass was scheduled or running was for the old model.
+    scheduler->cancel();
+    source_revision++;
+
+    cache.setModel(source_model);
+    invalidateAcceptedRows();
+    invalidateTrigramIndexes();
+    if (source_model != nullptr) {
+        source_connections.append(connect(source_model, &QAbstractItemModel::dataChanged, this, &QTableViewSortFilterProxyModel::sourceDataChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeInserted, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeMoved, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::columnsAboutToBeInserted, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::columnsAboutToBeRemoved, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::columnsAboutToBeMoved, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::modelAboutToBeReset, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::layoutAboutToBeChanged, this, &QTableViewSortFilterProxyModel::sourceStructureChanged));
+    }
+
+    QSortFilterProxyModel::setSourceModel(source_model);
+}
+
+// Function called when data changes in the source model. Changes on roles we don't read don't invalidate anything.
+void QTableViewSortFilterProxyModel::sourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right, const QVector<int> &roles) {
+    if (!affectsDisplayData(roles) || top_left.parent().isValid()) {
+        return;
+    }
+
+    cache.updateCells(top_left.row(), bottom_right.row(), top_left.column(), bottom_right.column());
+    source_revision++;
+    invalidateAcceptedRows();
+    invalidateSortRanks();
+
+    // Only the indexes of the changed columns are outdated.
+    for (int column = top_left.column(); column <= bottom_right.column(); ++column) {
+        trigram_indexes.remove(column);
+    }
+    trigram_indexes_building.clear();
+    trigram_generation++;
+}
+
+// Function called when rows or columns are added, removed or moved in the source model. Row numbers are no longer valid after this.
+void QTableViewSortFilterProxyModel::sourceStructureChanged() {
+    cache.invalidate();
+    source_revision++;
+    invalidateAcceptedRows();
+    invalidateSortRanks();
+    invalidateTrigramIndexes();
+}
+
+// Function to request a new filter plan. It gets applied once the debounce window of the scheduler is over.
+void QTableViewSortFilterProxyModel::scheduleFilterPlan(const FilterPlan &new_plan) {
+    scheduler->schedule([this, new_plan]() {
+        setFilterPlan(new_plan);
+    });
+}
+
+// Function to start filtering the model with a plan, cancelling any pass still running.
+//
+// Small tables are filtered right away, row by row, over the cache. Big ones get a parallel pass in the background, and keep showing
+// the results of the current plan until it's done.
+void QTableViewSortFilterProxyModel::setFilterPlan(const FilterPlan &new_plan) {
+    InstrumentationScope scope(InstrumentationProbe::TableFilterPass);
+    const int generation = scheduler->beginPass();
+
+    const QAbstractItemModel* model = sourceModel();
+    if (model == nullptr || new_plan.accepts_all || parallel_filter_min_rows <= 0 || model->rowCount() < parallel_filter_min_rows) {
+        new_plan.loadColumns(cache);
+        plan = new_plan;
+        invalidateAcceptedRows();
+        invalidateFilter();
+        return;
+    }
+
+    // The model can only be read from here, so the columns the pass needs are loaded before it starts.
+    new_plan.loadColumns(cache);
+
+    // If the user only extended the previous patterns, only the rows that passed the previous filter need to be checked again.
+    // Otherwise, if the trigram indexes can tell us which rows may pass, only those get checked.
+    QVector<int> candidates;
+    bool use_candidates = false;
+    if (accepted_rows_valid && new_plan.narrows(plan)) {
+        candidates = accepted_row_list;
+        use_candidates = true;
+    } else {
+        use_candidates = trigramCandidates(new_plan, candidates);
+    }
+
+    QThreadPool::globalInstance()->start(new FilterPassTask(this, generation, source_revision, new_plan, cache, model->rowCount(), candidates, use_candidates, scheduler->token()));
+}
+
+// Function to receive the results of a pass run in the background. Results of old passes are dropped, and passes
+// that finished after the source model changed are run again, as their rows may no longer match.
+void QTableViewSortFilterProxyModel::installFilterPass(int generation, int revision, const FilterPlan &pass_plan, const QVector<quint8> &results, const QVector<int> &row_list) {
+    InstrumentationScope scope(InstrumentationProbe::TableFilterPass);
+    if (!scheduler->isCurrent(generation)) {
+        return;
+    }
+
+    if (revision != source_revision) {
+        setFilterPlan(pass_plan);
+        return;
+    }
+
+    plan = pass_plan;
+    accepted_rows = results;
+    accepted_row_list = row_list;
+    accepted_rows_valid = true;
+    invalidateFilter();
+}
+
+// Function to forget the results of the last parallel pass. From here on, rows are filtered one by one until the next pass.
+void QTableViewSortFilterProxyModel::invalidateAcceptedRows() {
+    accepted_rows_valid = false;
+    accepted_rows.clear();
+    accepted_row_list.clear();
+}
+
+// Function to enable/disable the trigram indexes. Disabling them frees them.
+void QTableViewSortFilterProxyModel::setTrigramIndexEnabled(bool enabled) {
+    use_trigram_index = enabled;
+    if (!enabled) {
+        invalidateTrigramIndexes();
+    }
+}
+
+// Function to drop all the trigram indexes. Any index still being built will be discarded when it arrives.
+void QTableViewSortFilterProxyModel::invalidateTrigramIndexes() {
+    trigram_indexes.clear();
+    trigram_indexes_building.clear();
+    trigram_generation++;
+}
+
+// Function to receive a trigram index built in the background.
+void QTableViewSortFilterProxyModel::installTrigramIndex(int column, int generation, QSharedPointer<const TrigramIndex> index) {
+    if (!use_trigram_index || generation != trigram_generation) {
+        return;
+    }
+
+    trigram_indexes_building.remove(column);
+    trigram_indexes.insert(column, index);
+}
+
+// Function to start building the trigram index of a column in the background, if it's not already being built.
+void QTableViewSortFilterProxyModel::requestTrigramIndex(int column) {
+    if (trigram_indexes.contains(column) || trigram_indexes_building.contains(column) || !cache.isLoaded(column)) {
+        return;
+    }
+
+    // Checkbox columns are filtered by their state, not their text, so an index of the text is useless there.
+    const CachedColumn &cached = cache.at(column);
+    if (cached.check_state.contains(0) || cached.check_state.contains(1)) {
+        return;
+    }
+
+    trigram_indexes_building.insert(column);
+    QThreadPool::globalInstance()->start(new TrigramIndexTask(this, column, trigram_generation, cached.text, cached.offsets));
+}
+
+// Function to check if a match can use a trigram index.
+static bool isTrigramSearchable(const FilterMatch &match) {
+    return match.is_literal && match.use_regex && match.pattern.count() >= 3;
+}
+
+// Function to get the sorted list of rows that may pass the plan, according to the trigram indexes.
+//
+// Returns false if that cannot be known, because some group has no indexed literal. Columns that could use an index
+// but don't have one yet get it built in the background for the next time.
+bool QTableViewSortFilterProxyModel::trigramCandidates(const FilterPlan &filter_plan, QVector<int> &candidates) {
+    if (!use_trigram_index) {
+        return false;
+    }
+
+    for (const QVector<FilterMatch> &group: filter_plan.groups) {
+        for (const FilterMatch &match: group) {
+            if (isTrigramSearchable(match)) {
+                requestTrigramIndex(match.column);
+            }
+        }
+    }
+
+    // A row may pass if it may pass any group. And it may pass a group if it may pass all its indexed matches.
+    QVector<int> result;
+    for (const QVector<FilterMatch> &group: filter_plan.groups) {
+        bool group_has_index = false;
+        QVector<int> group_rows;
+
+        for (const FilterMatch &match: group) {
+            QSharedPointer<const TrigramIndex> index = trigram_indexes.value(match.column);
+            const QString folded_pattern = match.pattern.toCaseFolded();
+            if (!isTrigramSearchable(match) || index.isNull() || !index->canSearch(folded_pattern)) {
+                continue;
+            }
+
+            QVector<int> rows = index->candidates(folded_pattern);
+            if (match.show_blank_cells) {
+                QVector<int> with_blanks;
+                std::set_union(rows.constBegin(), rows.constEnd(), index->blankRows().constBegin(), index->blankRows().constEnd(), std::back_inserter(with_blanks));
+                rows = with_blanks;
+            }
+
+            if (group_has_index) {
+                QVector<int> intersection;
+                std::set_intersection(group_rows.constBegin(), group_rows.constEnd(), rows.constBegin(), rows.constEnd(), std::back_inserter(intersection));
+                group_rows = intersection;
+            } else {
+                group_rows = rows;
+                group_has_index = true;
+            }
+        }
+
+        if (!group_has_index) {
+            return false;
+        }
+
+        QVector<int> merged;
+        std::set_union(result.constBegin(), result.constEnd(), group_rows.constBegin(), group_rows.constEnd(), std::back_inserter(merged));
+        result = merged;
+    }
+
+    candidates = result;
+    return true;
+}
+
+// Function called when the filter changes.
+bool QTableViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+    InstrumentationScope scope(InstrumentationProbe::TableFilterAcceptsRow);
+    if (plan.accepts_all) {
+        return true;
+    }
+
+    // If we have the results of a parallel pass, just use them.
+    if (accepted_rows_valid && !source_parent.isValid() && source_row < accepted_rows.count()) {
+        return accepted_rows.at(source_row) == 1;
+    }
+
+    // Otherwise, the row is checked against the cache, same as a parallel pass does. The columns are only read from the model
+    // the first time, or after the cache gets invalidated by a change in the source model.
+    plan.loadColumns(cache);
+    return plan.acceptsRow(source_row, cache);
+}
+
+// Function to compare two rows of a cached column, the same way the generic lessThan compares their display data.
+// Case insensitive comparisons use the folded texts, so they're just a binary comparison.
+static bool cachedLessThan(const CachedColumn &column, int left_row, int right_row, Qt::CaseSensitivity case_sensitivity) {
+    const qint8 left_check_state = column.check_state.at(left_row);
+    const qint8 right_check_state = column.check_state.at(right_row);
+    if (left_check_state != -1 && right_check_state != -1) {
+        return left_check_state == 0 && right_check_state == 1;
+    }
+
+    switch (column.type) {
+        case CachedColumnType::Integer:
+            return column.integers.at(left_row) < column.integers.at(right_row);
+        case CachedColumnType::Float:
+            return column.floats.at(left_row) < column.floats.at(right_row);
+        default:
+            if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive && column.has_folded_text) {
+                return column.foldedCell(left_row).compare(column.foldedCell(right_row), Qt::CaseSensitivity::CaseSensitive) < 0;
+            } else {
+                return column.cell(left_row).compare(column.cell(right_row), case_sensitivity) < 0;
+            }
+    }
+}
+
+// Function to check if the ranks from the last sort can be used to compare these indexes.
+bool QTableViewSortFilterProxyModel::hasSortRanks(const QModelIndex &left, const QModelIndex &right) const {
+    return sort_ranks_column != -1 &&
+        left.column() == sort_ranks_column && right.column() == sort_ranks_column &&
+        !left.parent().isValid() && !right.parent().isValid() &&
+        left.row() < sort_ranks.count() && right.row() < sort_ranks.count() &&
+        sortRole() == Qt::DisplayRole && !isSortLocaleAware() &&
+        sortCaseSensitivity() == sort_ranks_case_sensitivity;
+}
+
+// Function to sort the table. Before the base class sorts it, we sort the keys of the column once, in parallel,
+// and turn the result into a rank per row. That way, every comparison the base class does is just an integer comparison.
+void QTableViewSortFilterProxyModel::sort(int column, Qt::SortOrder order) {
+    buildSortRanks(column);
+    QSortFilterProxyModel::sort(column, order);
+}
+
+// Function to forget the ranks of the last sort.
+void QTableViewSortFilterProxyModel::invalidateSortRanks() {
+    sort_ranks.clear();
+    sort_ranks_column = -1;
+}
+
+// Function to compute the rank of every row of the source model for the provided column. Rows with equal keys get equal ranks,
+// so the base class's stable sort keeps them in the same order it would without ranks.
+void QTableViewSortFilterProxyModel::buildSortRanks(int column) {
+    invalidateSortRanks();
+
+    if (column < 0 || column >= cache.columnCount() || sortRole() != Qt::DisplayRole || isSortLocaleAware()) {
+        return;
+    }
+
+    const Qt::CaseSensitivity case_sensitivity = sortCaseSensitivity();
+    if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+        cache.foldedColumn(column);
+    }
+
+    const CachedColumn &cached = cache.numericColumn(column);
+    const int rows = cached.rowCount();
+    auto less = [&](int left_row, int right_row) {
+        return cachedLessThan(cached, left_row, right_row, case_sensitivity);
+    };
+
+    QVector<int> order(rows);
+    int* rows_sorted = order.data();
+    for (int row = 0; row < rows; ++row) {
+        rows_sorted[row] = row;
+    }
+
+    // Sort chunks in parallel, then merge them in pairs until only one is left.
+    const int chunks = qMax(1, qMin(QThreadPool::globalInstance()->maxThreadCount(), rows / 4096));
+    QVector<int> bounds(chunks + 1);
+    for (int i = 0; i <= chunks; ++i) {
+        bounds[i] = static_cast<int>(static_cast<qint64>(rows) * i / chunks);
+    }
+
+    parallel_for(chunks, 1, [&](int begin, int end) {
+        for (int chunk = begin; chunk < end; ++chunk) {
+            std::stable_sort(rows_sorted + bounds.at(chunk), rows_sorted + bounds.at(chunk + 1), less);
+        }
+    });
+
+    for (int width = 1; width < chunks; width *= 2) {
+        const int pairs = (chunks + (2 * width) - 1) / (2 * width);
+        parallel_for(pairs, 1, [&](int begin, int end) {
+            for (int pair = begin; pair < end; ++pair) {
+                int first = pair * 2 * width;
+                int middle = qMin(first + width, chunks);
+                int last = qMin(first + (2 * width), chunks);
+                if (middle < last) {
+                    std::inplace_merge(rows_sorted + bounds.at(first), rows_sorted + bounds.at(middle), rows_sorted + bounds.at(last), less);
+                }
+            }
+        });
+    }
+
+    sort_ranks.resize(rows);
+    for (int i = 0; i < rows; ++i) {
+        if (i > 0 && !less(rows_sorted[i - 1], rows_sorted[i])) {
+            sort_ranks[rows_sorted[i]] = sort_ranks.at(rows_sorted[i - 1]);
+        } else {
+            sort_ranks[rows_sorted[i]] = i;
+        }
+    }
+
+    sort_ranks_column = column;
+    sort_ranks_case_sensitivity = case_sensitivity;
+}
+
 // Function called when the filter changes.
 bool QTableViewSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const {
+    InstrumentationScope scope(InstrumentationProbe::TableLessThan);
+
+    // If we have the ranks of the column, that's all we need.
+    if (hasSortRanks(left, right)) {
+        return sort_ranks.at(left.row()) < sort_ranks.at(right.row());
+    }
+
+    // Comparisons within a column of the table read from the cache, as long as the sort works over the display data.
+    if (left.column() == right.column() && !left.parent().isValid() && !right.parent().isValid() &&
+        sortRole() == Qt::DisplayRole && !isSortLocaleAware() &&
+        left.column() >= 0 && left.column() < sourceModel()->columnCount()) {
+
+        const CachedColumn &column = cache.numericColumn(left.column());
+        if (left.row() < column.rowCount() && right.row() < column.rowCount()) {
+            return cachedLessThan(column, left.row(), right.row(), sortCaseSensitivity());
+        }
+    }
 
-    QStandardItem *leftData = static_cast<QStandardItemModel*>(sourceModel())->itemFromIndex(left);
-    QStandardItem *rightData = static_cast<QStandardItemModel*>(sourceModel())->itemFromIndex(right);
+    const qint8 left_check_state = filterCheckState(left);
+    const qint8 right_check_state = filterCheckState(right);
 
-    if (leftData->isCheckable() && rightData->isCheckable()) {
-        if (leftData->checkState() == rightData->checkState()) {
+    if (left_check_state != -1 && right_check_state != -1) {
+        if (left_check_state == right_check_state) {
             return false;
-        } else if (leftData->checkState() == Qt::CheckState::Checked && rightData->checkState() == Qt::CheckState::Unchecked) {
+        } else if (left_check_state == 1 && right_check_state == 0) {
             return false;
         } else {
             return true;
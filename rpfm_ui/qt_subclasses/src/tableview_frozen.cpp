@@ -30,57 +30,27 @@ extern "C" void toggle_freezer(QTableView* tableView, int column) {
     tableViewFrozen->toggleFreezer(column);
 }
 
-// Constructor of QTableViewFrozen.
+// Function to enable from other languages the uniform row height mode of a QTableViewFrozen. A height of 0 or less uses the default height of the rows.
+extern "C" void set_uniform_row_height(QTableView* tableView, int height) {
+    QTableViewFrozen* tableViewFrozen = dynamic_cast<QTableViewFrozen*>(tableView);
+    tableViewFrozen->setUniformRowHeight(height);
+}
+
+// Function to make the frozen view use the delegates of the primary one. Rust calls it after setting up the delegates.
+extern "C" void share_frozen_delegates(QTableView* tableView) {
+    QTableViewFrozen* tableViewFrozen = dynamic_cast<QTableViewFrozen*>(tableView);
+    tableViewFrozen->shareDelegates();
+}
+
+// Constructor of QTableViewFrozen. The frozen view is just created here. It gets configured once we have a model.
 QTableViewFrozen::QTableViewFrozen(QWidget* parent) {
 
     this->setParent(parent);
     frozenColumns = QList<int>();
-    tableViewFrozen = new QTableView(parent);
-
-    // Connect the header's resize signal of both QTableViews together, so they keep the same size.
-    //connect(
-    //    horizontalHeader(),
-    //    &QHeaderView::sectionResized,
-    //    this,
-    //    &QTableViewFrozen::updateSectionWidth
-    //);
-    //
-    //connect(
-    //    verticalHeader(),
-    //    &QHeaderView::sectionResized,
-    //    this,
-    //    &QTableViewFrozen::updateSectionHeight
-    //);
-    //
-    //// Connect the vertical scrollbars, so both QTableViews are kept in sync.
-    //connect(
-    //    tableViewFrozen->verticalScrollBar(),
-    //    &QAbstractSlider::valueChanged,
-    //    verticalScrollBar(),
-    //    &QAbstractSlider::setValue
-    //);
-    //
-    //connect(
-    //    verticalScrollBar(),
-    //    &QAbstractSlider::valueChanged,
-    //    tableViewFrozen->verticalScrollBar(),
-    //    &QAbstractSlider::setValue
-    //);
-    //
-    //// Connect the sort indicators of both QTableViews, so they're kept in sync.
-    //connect(
-    //    horizontalHeader(),
-    //    &QHeaderView::sortIndicatorChanged,
-    //    tableViewFrozen->horizontalHeader(),
-    //    &QHeaderView::setSortIndicator
-    //);
-    //
-    //connect(
-    //    tableViewFrozen->horizontalHeader(),
-    //    &QHeaderView::sortIndicatorChanged,
-    //    horizontalHeader(),
-    //    &QHeaderView::setSortIndicator
-    //);
+    tableViewFrozen = new QTableView(this);
+    tableViewFrozen->setVisible(false);
+    tableViewFrozen->setFocusPolicy(Qt::NoFocus);
+    tableViewFrozen->setContextMenuPolicy(Qt::ContextMenuPolicy::CustomContextMenu);
 }
 
 // Destructor. Nothing to see here, keep scrolling.
@@ -93,16 +63,42 @@ void QTableViewFrozen::setDataModel(QAbstractItemModel * model) {
     init();
 }
 
-// QTableViewFrozen initializer. To prepare our frozenTableView to look and behave properly.
-void QTableViewFrozen::init() {
+// Function to make all the rows of the view the same height, for tables that only have single-line cells.
+//
+// The vertical headers get fixed to a single height, so they don't need to keep the size of each row, and the rows are never sized
+// through the size hints of their cells. That way, things like scrolling or sorting don't depend on the amount of rows.
+void QTableViewFrozen::setUniformRowHeight(int height) {
+    if (height <= 0) {
+        height = verticalHeader()->defaultSectionSize();
+    }
 
-    // Configure the QTableViews to "fit" above the normal QTableView, using his same model.
-    tableViewFrozen->setModel(model());
-    tableViewFrozen->setFocusPolicy(Qt::NoFocus);
-    tableViewFrozen->verticalHeader()->hide();
-    tableViewFrozen->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    uniform_row_height = height;
+    applyUniformRowHeight(this);
+    if (frozen_view_initialized) {
+        applyUniformRowHeight(tableViewFrozen);
+    }
+}
 
-    // Configure (almost) the same way both tables.
+// Function to fix the vertical header of one of the views to the uniform row height.
+void QTableViewFrozen::applyUniformRowHeight(QTableView* view) {
+    QHeaderView* rows = view->verticalHeader();
+    rows->setMinimumSectionSize(qMin(rows->minimumSectionSize(), uniform_row_height));
+    rows->setMaximumSectionSize(qMax(rows->maximumSectionSize(), uniform_row_height));
+    rows->setDefaultSectionSize(uniform_row_height);
+    rows->setSectionResizeMode(QHeaderView::Fixed);
+}
+
+// Function to get the height a row wants. In uniform row height mode, we don't ask the cells.
+int QTableViewFrozen::sizeHintForRow(int row) const {
+    if (uniform_row_height > 0) {
+        return uniform_row_height;
+    }
+
+    return QTableView::sizeHintForRow(row);
+}
+
+// QTableViewFrozen initializer. To prepare our QTableView to look and behave properly. The frozen one is left for when it's needed.
+void QTableViewFrozen::init() {
     horizontalHeader()->setVisible(true);
     verticalHeader()->setVisible(true);
     horizontalHeader()->setSortIndicator(-1, Qt::SortOrder::AscendingOrder);
@@ -111,130 +107,268 @@ void QTableViewFrozen::init() {
     horizontalHeader()->setSectionsMovable(true);
     setContextMenuPolicy(Qt::ContextMenuPolicy::CustomContextMenu);
 
-    tableViewFrozen->horizontalHeader()->setSortIndicator(-1, Qt::SortOrder::AscendingOrder);
-    tableViewFrozen->setSortingEnabled(true);
-    tableViewFrozen->setAlternatingRowColors(true);
-    tableViewFrozen->setContextMenuPolicy(Qt::ContextMenuPolicy::CustomContextMenu);
+    setHorizontalScrollMode(ScrollPerPixel);
+    setVerticalScrollMode(ScrollPerPixel);
 
-    // Place the Frozen QTableView above the normal one.
-    //viewport()->stackUnder(tableViewFrozen);
+    // If the model got replaced after the frozen view was set up, point it to the new one.
+    if (frozen_view_initialized) {
+        tableViewFrozen->setModel(model());
+        tableViewFrozen->setSelectionModel(selectionModel());
+        updateSectionCount(0, tableViewFrozen->horizontalHeader()->count());
+    }
+}
+
+// Function to set up the frozen view, the first time a column gets frozen.
+//
+// It gets the model and selection of this view, and copies the columns order and sizes and the row heights from it.
+// From then on, it's this view the one that computes them, and the frozen one just follows.
+void QTableViewFrozen::initFrozenView() {
+    if (frozen_view_initialized || model() == nullptr) {
+        return;
+    }
+
+    frozen_view_initialized = true;
 
+    tableViewFrozen->setModel(model());
     tableViewFrozen->setSelectionModel(selectionModel());
+    tableViewFrozen->verticalHeader()->hide();
+    tableViewFrozen->horizontalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tableViewFrozen->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tableViewFrozen->setAlternatingRowColors(true);
     tableViewFrozen->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     tableViewFrozen->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    tableViewFrozen->show();
-
-    QSortFilterProxyModel* filterModelFrozen = dynamic_cast<QSortFilterProxyModel*>(this->model());
-    for(int col = 0; col < filterModelFrozen->sourceModel()->columnCount(); col++)
-        tableViewFrozen->setColumnHidden(col, true);
-
-    setHorizontalScrollMode(ScrollPerPixel);
-    setVerticalScrollMode(ScrollPerPixel);
     tableViewFrozen->setHorizontalScrollMode(ScrollPerPixel);
     tableViewFrozen->setVerticalScrollMode(ScrollPerPixel);
-
+    tableViewFrozen->setSortingEnabled(false);
     tableViewFrozen->setStyleSheet("QTableView { "
         "border: none;"
         "selection-background-color: #999}"
     );
 
+    // Columns: same order and width, but only the frozen ones visible.
+    QHeaderView* header = horizontalHeader();
+    QHeaderView* header_frozen = tableViewFrozen->horizontalHeader();
+    header_frozen->setStretchLastSection(false);
+    header_frozen->setSectionsClickable(true);
+    header_frozen->setSortIndicatorShown(true);
+    header_frozen->setSortIndicator(header->sortIndicatorSection(), header->sortIndicatorOrder());
+    for (int visual_index = 0; visual_index < header->count(); ++visual_index) {
+        int logical_index = header->logicalIndex(visual_index);
+        int frozen_visual_index = header_frozen->visualIndex(logical_index);
+        if (frozen_visual_index != visual_index) {
+            header_frozen->moveSection(frozen_visual_index, visual_index);
+        }
+
+        header_frozen->resizeSection(logical_index, header->sectionSize(logical_index));
+        tableViewFrozen->setColumnHidden(logical_index, !frozenColumns.contains(logical_index));
+    }
+
+    // Rows: only the ones not using the default height need to be copied. With uniform rows, there are none.
+    QHeaderView* rows = verticalHeader();
+    QHeaderView* rows_frozen = tableViewFrozen->verticalHeader();
+    if (uniform_row_height > 0) {
+        applyUniformRowHeight(tableViewFrozen);
+    }
+    else {
+        rows_frozen->setMinimumSectionSize(rows->minimumSectionSize());
+        rows_frozen->setMaximumSectionSize(rows->maximumSectionSize());
+        rows_frozen->setDefaultSectionSize(rows->defaultSectionSize());
+        for (int row = 0; row < rows->count(); ++row) {
+            int size = rows->sectionSize(row);
+            if (size != rows_frozen->defaultSectionSize()) {
+                rows_frozen->resizeSection(row, size);
+            }
+        }
+    }
+
+    // Keep both views in sync from now on.
+    connect(header, &QHeaderView::sectionResized, this, &QTableViewFrozen::updateSectionWidth);
+    connect(header, &QHeaderView::sectionMoved, this, &QTableViewFrozen::updateSectionPosition);
+    connect(rows, &QHeaderView::sectionResized, this, &QTableViewFrozen::updateSectionHeight);
+    connect(header_frozen, &QHeaderView::sectionCountChanged, this, &QTableViewFrozen::updateSectionCount);
+    connect(header, &QHeaderView::sortIndicatorChanged, this, &QTableViewFrozen::updateSortIndicator);
+    connect(header_frozen, &QHeaderView::sectionClicked, this, &QTableViewFrozen::sortFromFrozenHeader);
+    connect(tableViewFrozen->verticalScrollBar(), &QAbstractSlider::valueChanged, verticalScrollBar(), &QAbstractSlider::setValue);
+    connect(verticalScrollBar(), &QAbstractSlider::valueChanged, tableViewFrozen->verticalScrollBar(), &QAbstractSlider::setValue);
+    tableViewFrozen->verticalScrollBar()->setValue(verticalScrollBar()->value());
+
+    shareDelegates();
+
+    // Place the Frozen QTableView above the normal one.
+    viewport()->stackUnder(tableViewFrozen);
+}
+
+// Function to undo initFrozenView, once there are no frozen columns left.
+//
+// The frozen view gets disconnected from everything and loses its model, so resets, resizes and scrolls of this view no longer reach it.
+void QTableViewFrozen::releaseFrozenView() {
+    if (!frozen_view_initialized) {
+        return;
+    }
+
+    frozen_view_initialized = false;
+
+    QHeaderView* header = horizontalHeader();
+    QHeaderView* header_frozen = tableViewFrozen->horizontalHeader();
+    disconnect(header, &QHeaderView::sectionResized, this, &QTableViewFrozen::updateSectionWidth);
+    disconnect(header, &QHeaderView::sectionMoved, this, &QTableViewFrozen::updateSectionPosition);
+    disconnect(verticalHeader(), &QHeaderView::sectionResized, this, &QTableViewFrozen::updateSectionHeight);
+    disconnect(header_frozen, &QHeaderView::sectionCountChanged, this, &QTableViewFrozen::updateSectionCount);
+    disconnect(header, &QHeaderView::sortIndicatorChanged, this, &QTableViewFrozen::updateSortIndicator);
+    disconnect(header_frozen, &QHeaderView::sectionClicked, this, &QTableViewFrozen::sortFromFrozenHeader);
+    disconnect(tableViewFrozen->verticalScrollBar(), &QAbstractSlider::valueChanged, verticalScrollBar(), &QAbstractSlider::setValue);
+    disconnect(verticalScrollBar(), &QAbstractSlider::valueChanged, tableViewFrozen->verticalScrollBar(), &QAbstractSlider::setValue);
+
     tableViewFrozen->setVisible(false);
-    //updateFrozenTableGeometry();
+    tableViewFrozen->setModel(nullptr);
+}
+
+// Function to make the frozen view use the same delegate instances as this one, instead of having its own.
+//
+// The delegates pool their editors per parent widget, so sharing them between both views is safe.
+void QTableViewFrozen::shareDelegates() {
+    if (!frozen_view_initialized || model() == nullptr) {
+        return;
+    }
+
+    for (int column = 0; column < model()->columnCount(); ++column) {
+        tableViewFrozen->setItemDelegateForColumn(column, itemDelegateForColumn(column));
+    }
+}
+
+// Function to show in the frozen view the sort indicator of this one. This view is the one sorting, so there's only one indicator.
+void QTableViewFrozen::updateSortIndicator(int logicalIndex, Qt::SortOrder order) {
+    tableViewFrozen->horizontalHeader()->setSortIndicator(logicalIndex, order);
+}
+
+// Function to sort this view when clicking the header of the frozen view, the same way clicking its own header would.
+void QTableViewFrozen::sortFromFrozenHeader(int logicalIndex) {
+    QHeaderView* header = horizontalHeader();
+    Qt::SortOrder order = Qt::AscendingOrder;
+    if (header->sortIndicatorSection() == logicalIndex && header->sortIndicatorOrder() == Qt::AscendingOrder) {
+        order = Qt::DescendingOrder;
+    }
+
+    header->setSortIndicator(logicalIndex, order);
 }
 
 // Function to change the width columns at the same time we resize them in the main QTableView.
-//void QTableViewFrozen::updateSectionWidth(int logicalIndex, int /* oldSize */, int newSize) {
-//    tableViewFrozen->setColumnWidth(logicalIndex, newSize);
-//    updateFrozenTableGeometry();
-//}
+void QTableViewFrozen::updateSectionWidth(int logicalIndex, int /* oldSize */, int newSize) {
+    tableViewFrozen->horizontalHeader()->resizeSection(logicalIndex, newSize);
+    if (frozenColumns.contains(logicalIndex)) {
+        updateFrozenTableGeometry();
+    }
+}
 
 // Function to change the height columns at the same time we resize them in the main QTableView.
-//void QTableViewFrozen::updateSectionHeight(int logicalIndex, int /* oldSize */, int newSize) {
-//    tableViewFrozen->setRowHeight(logicalIndex, newSize);
-//}
+void QTableViewFrozen::updateSectionHeight(int logicalIndex, int /* oldSize */, int newSize) {
+    tableViewFrozen->verticalHeader()->resizeSection(logicalIndex, newSize);
+}
+
+// Function to move the columns at the same time we move them in the main QTableView.
+void QTableViewFrozen::updateSectionPosition(int /* logicalIndex */, int oldVisualIndex, int newVisualIndex) {
+    tableViewFrozen->horizontalHeader()->moveSection(oldVisualIndex, newVisualIndex);
+}
+
+// Function to hide the new columns of the frozen view when the model gets new ones, or gets reset.
+void QTableViewFrozen::updateSectionCount(int /* oldCount */, int newCount) {
+    for (int column = 0; column < newCount; ++column) {
+        tableViewFrozen->setColumnHidden(column, !frozenColumns.contains(column));
+        if (column < horizontalHeader()->count()) {
+            tableViewFrozen->horizontalHeader()->resizeSection(column, columnWidth(column));
+        }
+    }
+    updateFrozenTableGeometry();
+}
 
 // Function to trigger a full geometry update of the frozen QTableView when we resize the main one.
-//void QTableViewFrozen::resizeEvent(QResizeEvent* event) {
-//    QTableView::resizeEvent(event);
-//    updateFrozenTableGeometry();
-//}
+void QTableViewFrozen::resizeEvent(QResizeEvent* event) {
+    QTableView::resizeEvent(event);
+    updateFrozenTableGeometry();
+}
+
+// Function to get the width of all the frozen columns together.
+int QTableViewFrozen::frozenWidth() const {
+    int width = 0;
+    for (int column: frozenColumns) {
+        width += columnWidth(column);
+    }
+    return width;
+}
 
 // Function to keep the cursor always visible, so it never gets hidden under the Frozen Columns.
-//QModelIndex QTableViewFrozen::moveCursor(
-//    CursorAction cursorAction,
-//    Qt::KeyboardModifiers modifiers
-//) {
-//    QModelIndex current = QTableView::moveCursor(cursorAction, modifiers);
-//
-//    // We need to get this done dinamically, depending on the amount and size of frozen columns.
-//    int frozen_columns = 0;
-//    int frozen_width = 0;
-//    QSortFilterProxyModel* model = dynamic_cast<QSortFilterProxyModel*>(this->model());
-//    for (int i = 0; i < model->sourceModel()->columnCount(); ++i) {
-//        if (!tableViewFrozen->isColumnHidden(i)) {
-//            frozen_columns += 1;
-//            frozen_width += columnWidth(i);
-//        }
-//    }
-//
-//    if (cursorAction == MoveLeft &&
-//        current.column() >= frozen_columns  &&
-//        visualRect(current).topLeft().x() < frozen_width
-//    ){
-//        const int newValue = horizontalScrollBar()->value() + visualRect(current).topLeft().x() - frozen_width;
-//        horizontalScrollBar()->setValue(newValue);
-//    }
-//    return current;
-//}
+QModelIndex QTableViewFrozen::moveCursor(
+    CursorAction cursorAction,
+    Qt::KeyboardModifiers modifiers
+) {
+    QModelIndex current = QTableView::moveCursor(cursorAction, modifiers);
+    if (frozenColumns.isEmpty()) {
+        return current;
+    }
+
+    int frozen_width = frozenWidth();
+    if (cursorAction == MoveLeft &&
+        !frozenColumns.contains(current.column()) &&
+        visualRect(current).topLeft().x() < frozen_width
+    ){
+        const int newValue = horizontalScrollBar()->value() + visualRect(current).topLeft().x() - frozen_width;
+        horizontalScrollBar()->setValue(newValue);
+    }
+    return current;
+}
 
 // Function to make the FrozenTableView work in consonance with the QtableView when the selection is out of view.
-//void QTableViewFrozen::scrollTo(const QModelIndex & index, ScrollHint hint) {
-//    if (index.column() >= frozenColumns.count()) {
-//        QTableView::scrollTo(index, hint);
-//    }
-//}
+void QTableViewFrozen::scrollTo(const QModelIndex & index, ScrollHint hint) {
+    if (!frozenColumns.contains(index.column())) {
+        QTableView::scrollTo(index, hint);
+    }
+}
 
 // Function to update the geometry of the frozen QTableView when needed, to keep it at the right size.
-//void QTableViewFrozen::updateFrozenTableGeometry() {
-//
-//    // It's simple, we get the width of every visible column, then use that as our width.
-//    int width = 0;
-//    QSortFilterProxyModel* frozenTableModel = dynamic_cast<QSortFilterProxyModel*>(tableViewFrozen->model());
-//    width += frozenColumns.count();
-//    for (int i = 0; i < frozenTableModel->sourceModel()->columnCount(); ++i) {
-//        if (frozenColumns.contains(i)) {
-//            width += columnWidth(i);
-//        }
-//    }
-//
-//    if (frozenColumns.isEmpty()){
-//        tableViewFrozen->verticalHeader()->hide();
-//    }
-//    else {
-//        tableViewFrozen->verticalHeader()->show();
-//    }
-//
-//    QMargins margins = viewportMargins();
-//    margins.setLeft(verticalHeader()->width() + frameWidth() + width);
-//    setViewportMargins(margins);
-//
-//    tableViewFrozen->setGeometry(
-//        verticalHeader()->width() + frameWidth(),
-//        frameWidth(),
-//        width,
-//        viewport()->height()+horizontalHeader()->height()
-//    );
-//}
+void QTableViewFrozen::updateFrozenTableGeometry() {
+    if (!frozen_view_initialized) {
+        return;
+    }
+
+    if (frozenColumns.isEmpty()) {
+        tableViewFrozen->setVisible(false);
+        return;
+    }
 
+    tableViewFrozen->setGeometry(
+        verticalHeader()->width() + frameWidth(),
+        frameWidth(),
+        frozenWidth(),
+        viewport()->height() + horizontalHeader()->height()
+    );
+    tableViewFrozen->setVisible(true);
+}
+
+// Function to freeze/unfreeze a column. Frozen columns are moved to the left, after any other frozen column, so the frozen view can cover them.
 void QTableViewFrozen::toggleFreezer(int column) {
+    initFrozenView();
+    if (!frozen_view_initialized) {
+        return;
+    }
 
     if (frozenColumns.contains(column)) {
         frozenColumns.removeOne(column);
+        if (frozenColumns.isEmpty()) {
+            releaseFrozenView();
+            return;
+        }
+
         tableViewFrozen->setColumnHidden(column, true);
     }
     else {
+        QHeaderView* header = horizontalHeader();
+        int visual_index = header->visualIndex(column);
+        if (visual_index > frozenColumns.count()) {
+            header->moveSection(visual_index, frozenColumns.count());
+        }
+
         frozenColumns.append(column);
         tableViewFrozen->setColumnHidden(column, false);
     }
-    //updateFrozenTableGeometry();
+    updateFrozenTableGeometry();
 }
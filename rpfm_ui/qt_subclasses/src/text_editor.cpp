@@ -1,4 +1,20 @@
 #include "text_editor.h"
+#include "instrumentation.h"
+
+// Texts with more characters than this are loaded in chunks.
+const int LARGE_TEXT_SIZE = 1 << 20;
+
+// Characters inserted on each chunk. Chunks are cut at the end of a line.
+const int LARGE_TEXT_CHUNK_SIZE = 1 << 18;
+
+// Texts with more characters than this are left without highlighting.
+const int LARGE_TEXT_HIGHLIGHTING_LIMIT = 1 << 24;
+
+// Time in ms the view needs to be idle after a large load before enabling the highlighting.
+const int LARGE_TEXT_HIGHLIGHTING_DELAY = 500;
+
+// Highlighting mode without highlighting.
+const QString NO_HIGHLIGHTING = QStringLiteral("None");
 
 // Function to create the filter in a way that we don't need to bother Rust with new types.
 extern "C" QWidget* new_text_editor(QWidget* parent) {
@@ -8,30 +24,181 @@ extern "C" QWidget* new_text_editor(QWidget* parent) {
 
     // Disable the status bar.
     view->setStatusBarEnabled(false);
+
+    // Track the changes, so we can read back only the changed lines.
+    new TextEditorChangeTracker(doc);
+    new TextEditorLoader(doc);
     return dynamic_cast<QWidget*>(view);
 }
 
+// Function to get the change tracker of the document of a view.
+static TextEditorChangeTracker* changeTracker(KTextEditor::Document* doc) {
+    return doc->findChild<TextEditorChangeTracker*>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+// Function to get the loader of the document of a view.
+static TextEditorLoader* textLoader(KTextEditor::Document* doc) {
+    return doc->findChild<TextEditorLoader*>(QString(), Qt::FindDirectChildrenOnly);
+}
+
+// Function to set the text of a document, through its loader if it has one.
+static void loadText(KTextEditor::Document* doc, const QString &text, const QString &highlighting_mode) {
+    if (TextEditorLoader* loader = textLoader(doc)) {
+        loader->load(text, highlighting_mode);
+        return;
+    }
+
+    doc->setText(text);
+    if (!highlighting_mode.isNull()) {
+        doc->setHighlightingMode(highlighting_mode);
+    }
+
+    if (TextEditorChangeTracker* tracker = changeTracker(doc)) {
+        tracker->reset();
+    }
+}
+
+// Function to make sure a document has all its text before reading it.
+static void finishLoading(KTextEditor::Document* doc) {
+    if (TextEditorLoader* loader = textLoader(doc)) {
+        loader->finish();
+    }
+}
+
 // Function to return the current text of the Text Editor.
 extern "C" QString* get_text(QWidget* view) {
+    InstrumentationScope scope(InstrumentationProbe::TextEditorGetText);
 
     KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
     KTextEditor::Document* doc = doc_view->document();
-    QString text_object = doc->text();
-    QString* text = new QString(text_object);
-
-    return text;
+    finishLoading(doc);
+    return new QString(doc->text());
 }
 
 // Function to set the current text of the text editor.
 extern "C" void set_text(QWidget* view, QString* text, QString* highlighting_mode) {
+    InstrumentationScope scope(InstrumentationProbe::TextEditorSetText);
+
+    KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
+    KTextEditor::Document* doc = doc_view->document();
+    loadText(doc, *text, *highlighting_mode);
+}
+
+// Function to set the current text of the text editor straight from an UTF-8 buffer, so Rust doesn't need to build a QString first.
+extern "C" void set_text_utf8(QWidget* view, const char* text, qint64 length, QString* highlighting_mode) {
+    InstrumentationScope scope(InstrumentationProbe::TextEditorSetText);
+
+    KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
+    KTextEditor::Document* doc = doc_view->document();
+    loadText(doc, QString::fromUtf8(text, static_cast<int>(length)), highlighting_mode != nullptr ? *highlighting_mode : QString());
+}
+
+// Function to write the current text of the text editor as UTF-8 into the provided buffer, so Rust can read it without converting it again.
+extern "C" void get_text_utf8(QWidget* view, QByteArray* buffer) {
+    InstrumentationScope scope(InstrumentationProbe::TextEditorGetText);
+
+    KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
+    KTextEditor::Document* doc = doc_view->document();
+    finishLoading(doc);
+    *buffer = doc->text().toUtf8();
+}
+
+// Function to get the lines changed since the text was set (or the last reset).
+//
+// If there are any, it returns true, with the changed lines in text, the span they cover in the current text starting at first_line,
+// and the last line they replace in the original text. Lines are joined with \n.
+extern "C" bool get_modified_text(QWidget* view, int* first_line, int* original_last_line, QString* text) {
 
     KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
     KTextEditor::Document* doc = doc_view->document();
-    QString text_object = *text;
-    doc->setText(text_object);
+    finishLoading(doc);
+    TextEditorChangeTracker* tracker = changeTracker(doc);
+
+    int first = 0;
+    int last = 0;
+    int original_last = 0;
+    if (tracker == nullptr || !tracker->modifiedSpan(first, last, original_last)) {
+        return false;
+    }
+
+    *first_line = first;
+    *original_last_line = original_last;
+    *text = doc->text(KTextEditor::Range(first, 0, last, doc->lineLength(last)));
+    return true;
+}
 
-    QString highlight_mode = *highlighting_mode;
-    doc->setHighlightingMode(highlight_mode);
+// Function to mark the current text of the editor as unmodified, after its changes have been read back.
+extern "C" void reset_modified_text(QWidget* view) {
+
+    KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
+    if (TextEditorChangeTracker* tracker = changeTracker(doc_view->document())) {
+        tracker->reset();
+    }
+}
+
+// Function to make big texts stay read-only and without highlighting on the provided editor.
+extern "C" void set_text_editor_large_file_read_only(QWidget* view, bool read_only) {
+
+    KTextEditor::View* doc_view = dynamic_cast<KTextEditor::View*>(view);
+    if (TextEditorLoader* loader = textLoader(doc_view->document())) {
+        loader->large_file_read_only = read_only;
+    }
+}
+
+// Constructor of TextEditorChangeTracker. It lives as long as the document it tracks.
+TextEditorChangeTracker::TextEditorChangeTracker(KTextEditor::Document* document): QObject(document), document(document) {
+    connect(document, &KTextEditor::Document::textInserted, this, [this](KTextEditor::Document*, const KTextEditor::Cursor &position, const QString &text) {
+        int lines = text.count(QLatin1Char('\n'));
+        markChanged(position.line(), position.line() + lines, position.line(), lines);
+    });
+
+    connect(document, &KTextEditor::Document::textRemoved, this, [this](KTextEditor::Document*, const KTextEditor::Range &range, const QString &) {
+        int lines = range.end().line() - range.start().line();
+        markChanged(range.start().line(), range.start().line(), range.start().line(), -lines);
+    });
+
+    reset();
+}
+
+// Function to forget the changes, making the current text the original one.
+void TextEditorChangeTracker::reset() {
+    baseline_lines = document->lines();
+    modified = false;
+    span_first = 0;
+    span_last = 0;
+}
+
+// Function to get the span of changed lines, in current and original line numbers.
+bool TextEditorChangeTracker::modifiedSpan(int &first_line, int &last_line, int &original_last_line) const {
+    if (!modified) {
+        return false;
+    }
+
+    first_line = span_first;
+    last_line = qMin(span_last, document->lines() - 1);
+    original_last_line = last_line - (document->lines() - baseline_lines);
+    return true;
+}
+
+// Function to add the changed lines [first_line, last_line] to the span, after shifting it by delta lines if it goes past pivot_line.
+void TextEditorChangeTracker::markChanged(int first_line, int last_line, int pivot_line, int delta) {
+    if (modified) {
+        if (span_first > pivot_line) {
+            span_first = qMax(pivot_line, span_first + delta);
+        }
+
+        if (span_last > pivot_line) {
+            span_last = qMax(pivot_line, span_last + delta);
+        }
+
+        span_first = qMin(span_first, first_line);
+        span_last = qMax(span_last, last_line);
+    }
+    else {
+        modified = true;
+        span_first = first_line;
+        span_last = last_line;
+    }
 }
 
 // Function to trigger the config dialog of the text editor.
@@ -41,3 +208,117 @@ extern "C" void open_text_editor_config(QWidget* parent) {
     editor->configDialog(parent);
 }
 
+
+// Constructor of TextEditorLoader. It lives as long as the document it loads.
+TextEditorLoader::TextEditorLoader(KTextEditor::Document* document): QObject(document), document(document) {
+    chunk_timer = new QTimer(this);
+    chunk_timer->setInterval(0);
+    connect(chunk_timer, &QTimer::timeout, this, [this]() { loadNextChunk(); });
+
+    highlight_timer = new QTimer(this);
+    highlight_timer->setSingleShot(true);
+    highlight_timer->setInterval(LARGE_TEXT_HIGHLIGHTING_DELAY);
+    connect(highlight_timer, &QTimer::timeout, this, [this]() { this->document->setHighlightingMode(highlighting_mode); });
+
+    // Any change means the view is not idle, so the highlighting has to wait a bit more.
+    connect(document, &KTextEditor::Document::textChanged, this, [this]() {
+        if (highlight_timer->isActive()) {
+            highlight_timer->start();
+        }
+    });
+}
+
+// Function to set the text of the document, replacing any load in progress.
+void TextEditorLoader::load(const QString &text, const QString &mode) {
+    if (loading) {
+        chunk_timer->stop();
+        pending_text.clear();
+        loading = false;
+        document->setReadWrite(was_read_write);
+    }
+
+    highlight_timer->stop();
+    highlighting_mode = mode.isNull() ? document->highlightingMode() : mode;
+
+    if (text.size() <= LARGE_TEXT_SIZE) {
+        document->setText(text);
+        document->setHighlightingMode(highlighting_mode);
+        if (TextEditorChangeTracker* tracker = changeTracker(document)) {
+            tracker->reset();
+        }
+        return;
+    }
+
+    // Big texts start without highlighting and read-only, with the first chunk, so the view can paint it right away.
+    pending_text = text;
+    position = 0;
+    loading = true;
+    was_read_write = document->isReadWrite();
+    document->setHighlightingMode(NO_HIGHLIGHTING);
+    editWritable([this]() { document->setText(QString()); });
+    loadNextChunk();
+
+    if (loading) {
+        chunk_timer->start();
+    }
+}
+
+// Function to load the rest of the text right now. Used when someone needs the text, not just the view.
+void TextEditorLoader::finish() {
+    while (loading) {
+        loadNextChunk();
+    }
+}
+
+// Function to do an edit on the document, even if it's read-only.
+void TextEditorLoader::editWritable(const std::function<void()> &edit) {
+    document->setReadWrite(true);
+    edit();
+    document->setReadWrite(false);
+}
+
+// Function to append the next chunk of the text to the document.
+void TextEditorLoader::loadNextChunk() {
+    if (!loading) {
+        return;
+    }
+
+    int end = qMin(position + LARGE_TEXT_CHUNK_SIZE, pending_text.size());
+    if (end < pending_text.size()) {
+        int line_end = pending_text.lastIndexOf(QLatin1Char('\n'), end - 1);
+        if (line_end >= position) {
+            end = line_end + 1;
+        }
+    }
+
+    QString chunk = pending_text.mid(position, end - position);
+    editWritable([this, &chunk]() { document->insertText(document->documentEnd(), chunk); });
+    position = end;
+
+    if (position >= pending_text.size()) {
+        endLoad();
+    }
+}
+
+// Function to leave the document ready once all the text is in.
+void TextEditorLoader::endLoad() {
+    chunk_timer->stop();
+    loading = false;
+
+    const int size = pending_text.size();
+    pending_text.clear();
+
+    if (TextEditorChangeTracker* tracker = changeTracker(document)) {
+        tracker->reset();
+    }
+
+    if (large_file_read_only) {
+        document->setReadWrite(false);
+        return;
+    }
+
+    document->setReadWrite(was_read_write);
+    if (size <= LARGE_TEXT_HIGHLIGHTING_LIMIT && highlighting_mode != NO_HIGHLIGHTING) {
+        highlight_timer->start();
+    }
+}
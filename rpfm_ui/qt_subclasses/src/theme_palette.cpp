@@ -0,0 +1,87 @@
+#include "theme_palette.h"
+#include "settings_store.h"
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+
+// Loaded palettes, one per theme, and the generation they belong to.
+static QMutex palette_mutex;
+static QSharedPointer<const ThemePalette> dark_palette;
+static QSharedPointer<const ThemePalette> light_palette;
+static QAtomicInt palette_generation(0);
+
+// Function to drop the loaded palettes from any other language, after the colours have been changed in the settings.
+extern "C" void invalidate_theme_palette() {
+    ThemePalette::invalidate();
+}
+
+// Function to get the palette of a theme, loading it from the settings if needed.
+QSharedPointer<const ThemePalette> ThemePalette::get(bool dark_theme) {
+    QMutexLocker locker(&palette_mutex);
+    QSharedPointer<const ThemePalette> &palette = dark_theme ? dark_palette : light_palette;
+    if (palette.isNull()) {
+        palette = load(dark_theme);
+    }
+
+    return palette;
+}
+
+// Function to get the current generation of the palettes. It changes every time they're invalidated.
+int ThemePalette::generation() {
+    return palette_generation.loadAcquire();
+}
+
+// Function to drop the loaded palettes, so they get reloaded from the settings the next time they're requested.
+//
+// The colours were changed without going through the settings store, so its cache has to go too.
+void ThemePalette::invalidate() {
+    SettingsStore::instance()->reload();
+
+    QMutexLocker locker(&palette_mutex);
+    dark_palette.clear();
+    light_palette.clear();
+    palette_generation.fetchAndAddOrdered(1);
+}
+
+// Function to build a pen for the marks on the side of the cells.
+static QPen markPen(const QColor &colour, int width) {
+    QPen pen;
+    pen.setColor(colour);
+    pen.setStyle(Qt::PenStyle::SolidLine);
+    pen.setWidth(width);
+    return pen;
+}
+
+// Function to load the palette of a theme from the settings, and prebuild everything the delegates paint with.
+QSharedPointer<const ThemePalette> ThemePalette::load(bool dark_theme) {
+    SettingsStore* q_settings = SettingsStore::instance();
+    QString prefix = dark_theme ? QStringLiteral("colour_dark_") : QStringLiteral("colour_light_");
+
+    QSharedPointer<ThemePalette> palette(new ThemePalette());
+    palette->colour_table_added = QColor(q_settings->value(prefix + "table_added").toString());
+    palette->colour_table_modified = QColor(q_settings->value(prefix + "table_modified").toString());
+    palette->colour_diagnostic_error = QColor(q_settings->value(prefix + "diagnostic_error").toString());
+    palette->colour_diagnostic_warning = QColor(q_settings->value(prefix + "diagnostic_warning").toString());
+    palette->colour_diagnostic_info = QColor(q_settings->value(prefix + "diagnostic_info").toString());
+
+    // Background of the keys, to identify them.
+    QColor key_colour;
+    if (dark_theme) {
+        key_colour.setRgbF(82, 82, 0, 0.1);
+    } else {
+        key_colour.setRgbF(255, 255, 0, 0.1);
+    }
+
+    palette->key_brush = QBrush(key_colour);
+    palette->key_brush.setStyle(Qt::BrushStyle::SolidPattern);
+    palette->key_pen.setWidth(0);
+    palette->key_pen.setColor(key_colour);
+
+    palette->added_pen = markPen(palette->colour_table_added, 2);
+    palette->modified_pen = markPen(palette->colour_table_modified, 2);
+    palette->error_pen = markPen(palette->colour_diagnostic_error, 4);
+    palette->warning_pen = markPen(palette->colour_diagnostic_warning, 4);
+    palette->info_pen = markPen(palette->colour_diagnostic_info, 4);
+
+    return palette;
+}
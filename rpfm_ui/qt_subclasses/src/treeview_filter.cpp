@@ -1,7 +1,9 @@
 ﻿#include "treeview_filter.h"
+#include "instrumentation.h"
+#include "literal_matcher.h"
+#include "packed_file_model.h"
 #include <QSortFilterProxyModel>
 #include <QItemSelection>
-#include <QRegExp>
 #include <QStandardItem>
 #include <QStandardItemModel>
 
@@ -11,42 +13,254 @@ extern "C" QSortFilterProxyModel* new_treeview_filter(QObject *parent) {
     return dynamic_cast<QSortFilterProxyModel*>(filter);
 }
 
-// Funtion to trigger the filter we want, instead of the default one, from Rust.
-extern "C" void trigger_treeview_filter(QSortFilterProxyModel* filter, QRegExp* pattern) {
+// Funtion to trigger the filter we want with a plain pattern and flags, from Rust.
+extern "C" void trigger_treeview_filter_pattern(QSortFilterProxyModel* filter, QString* pattern, int flags) {
+    InstrumentationScope scope(InstrumentationProbe::TriggerTreeFilter);
     QTreeViewSortFilterProxyModel* filter2 = static_cast<QTreeViewSortFilterProxyModel*>(filter);
-    filter2->setFilterRegExp(*pattern);
+    Qt::CaseSensitivity case_sensitivity = (flags & TREEVIEW_FILTER_CASE_SENSITIVE) ? Qt::CaseSensitivity::CaseSensitive : Qt::CaseSensitivity::CaseInsensitive;
+    filter2->scheduleFilterPattern(pattern == nullptr ? QString() : *pattern, case_sensitivity);
+}
+
+// Function to check if a pattern has no regex metacharacters.
+static bool isLiteralPattern(const QString &pattern) {
+    static const QString metacharacters = QStringLiteral("\\^$.|?*+()[]{}");
+    for (const QChar &character: pattern) {
+        if (metacharacters.contains(character)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Function to compile a pattern into a matcher.
+//
+// A pattern that is a literal, optionally anchored with ^ and/or $, becomes a contains/prefix/suffix/exact check. Anything else
+// goes to an optimized QRegularExpression. An invalid regex matches nothing.
+TreeFilterMatcher TreeFilterMatcher::compile(const QString &pattern, Qt::CaseSensitivity case_sensitivity) {
+    TreeFilterMatcher matcher;
+    matcher.case_sensitivity = case_sensitivity;
+    if (pattern.isEmpty()) {
+        return matcher;
+    }
+
+    bool anchored_start = pattern.startsWith(QLatin1Char('^'));
+    bool anchored_end = pattern.length() > (anchored_start ? 1 : 0) && pattern.endsWith(QLatin1Char('$')) && !pattern.endsWith(QStringLiteral("\\$"));
+    QString literal = pattern.mid(anchored_start ? 1 : 0, pattern.length() - (anchored_start ? 1 : 0) - (anchored_end ? 1 : 0));
+
+    if (isLiteralPattern(literal)) {
+        if (anchored_start && anchored_end) {
+            matcher.kind = TreeFilterMatchKind::Exact;
+        } else if (anchored_start) {
+            matcher.kind = TreeFilterMatchKind::Prefix;
+        } else if (anchored_end) {
+            matcher.kind = TreeFilterMatchKind::Suffix;
+        } else {
+            matcher.kind = TreeFilterMatchKind::Contains;
+        }
+
+        // Case insensitive contains are searched, already folded, over the folded paths.
+        if (matcher.kind == TreeFilterMatchKind::Contains && case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+            matcher.literal = literal.toCaseFolded();
+        } else {
+            matcher.literal = literal;
+        }
+
+        // An anchored empty literal ("^" or "$") matches everything.
+        if (matcher.literal.isEmpty() && matcher.kind != TreeFilterMatchKind::Exact) {
+            matcher.kind = TreeFilterMatchKind::All;
+        }
+    } else {
+        QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+        if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+            options |= QRegularExpression::CaseInsensitiveOption;
+        }
+
+        matcher.kind = TreeFilterMatchKind::Regex;
+        matcher.regex = QRegularExpression(pattern, options);
+        matcher.regex.optimize();
+    }
+
+    return matcher;
+}
+
+// Function to check if a text matches the compiled pattern.
+bool TreeFilterMatcher::matches(const QString &text) const {
+    switch (kind) {
+        case TreeFilterMatchKind::All:
+            return true;
+
+        case TreeFilterMatchKind::Contains:
+            if (case_sensitivity == Qt::CaseSensitivity::CaseInsensitive) {
+                QString folded = text.toCaseFolded();
+                return literal_contains(folded.utf16(), folded.length(), literal.utf16(), literal.length());
+            }
+            return literal_contains(text.utf16(), text.length(), literal.utf16(), literal.length());
+
+        case TreeFilterMatchKind::Prefix:
+            return text.startsWith(literal, case_sensitivity);
+
+        case TreeFilterMatchKind::Suffix:
+            return text.endsWith(literal, case_sensitivity);
+
+        case TreeFilterMatchKind::Exact:
+            return text.compare(literal, case_sensitivity) == 0;
+
+        case TreeFilterMatchKind::Regex:
+            return regex.isValid() && regex.match(text).hasMatch();
+    }
+
+    return false;
 }
 
 // Constructor of QTreeViewSortFilterProxyModel.
-QTreeViewSortFilterProxyModel::QTreeViewSortFilterProxyModel(QObject *parent): QSortFilterProxyModel(parent) {}
+QTreeViewSortFilterProxyModel::QTreeViewSortFilterProxyModel(QObject *parent): QSortFilterProxyModel(parent) {
+    scheduler = new FilterScheduler(this);
+}
 
-// Function called when the filter changes.
-bool QTreeViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+// Function to set the source model. We connect to it before the base class does so the cache is cleared before the base class
+// re-filters the changed rows.
+void QTreeViewSortFilterProxyModel::setSourceModel(QAbstractItemModel *source_model) {
+    for (const QMetaObject::Connection &connection: source_connections) {
+        disconnect(connection);
+    }
+    source_connections.clear();
+
+    scheduler->cancel();
+    invalidateMatchCache();
+    if (source_model != nullptr) {
+        source_connections.append(connect(source_model, &QAbstractItemModel::dataChanged, this, &QTreeViewSortFilterProxyModel::sourceDataChanged));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeInserted, this, &QTreeViewSortFilterProxyModel::invalidateMatchCache));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, &QTreeViewSortFilterProxyModel::invalidateMatchCache));
+        source_connections.append(connect(source_model, &QAbstractItemModel::rowsAboutToBeMoved, this, &QTreeViewSortFilterProxyModel::invalidateMatchCache));
+        source_connections.append(connect(source_model, &QAbstractItemModel::modelAboutToBeReset, this, &QTreeViewSortFilterProxyModel::invalidateMatchCache));
+        source_connections.append(connect(source_model, &QAbstractItemModel::layoutAboutToBeChanged, this, &QTreeViewSortFilterProxyModel::invalidateMatchCache));
+    }
 
-    // Check the current item. If it's a file, we just call the parent's filter.
-    bool result = QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+    QSortFilterProxyModel::setSourceModel(source_model);
+}
+
+// Function to request a new pattern. It gets applied once the debounce window of the scheduler is over.
+void QTreeViewSortFilterProxyModel::scheduleFilterPattern(const QString &pattern, Qt::CaseSensitivity case_sensitivity) {
+    scheduler->schedule([this, pattern, case_sensitivity]() {
+        setFilterPattern(pattern, case_sensitivity);
+    });
+}
+
+// Function to compile a new pattern and re-filter the tree with it.
+//
+// The tree is filtered as the view asks for its rows, so there's nothing to run in the background. Its pass still gets its generation,
+// so the scheduler knows the last one applied.
+void QTreeViewSortFilterProxyModel::setFilterPattern(const QString &pattern, Qt::CaseSensitivity case_sensitivity) {
+    InstrumentationScope scope(InstrumentationProbe::TreeFilterPass);
+    scheduler->beginPass();
+
+    // Lazy trees need all their items to be filtered. Once created, they stay, so this is only slow the first time.
+    if (!pattern.isEmpty()) {
+        if (PackedFileModel* packed_file_model = dynamic_cast<PackedFileModel*>(sourceModel())) {
+            packed_file_model->fetchAll();
+        }
+    }
+
+    matcher = TreeFilterMatcher::compile(pattern, case_sensitivity);
+    invalidateMatchCache();
+    invalidateFilter();
+}
+
+// Function to forget the match state of all nodes. It has to be called every time the filter changes.
+void QTreeViewSortFilterProxyModel::invalidateMatchCache() {
+    match_cache.clear();
+}
+
+// Function called when data changes in the source model. A rename can change the visibility of every ancestor, so we drop it all.
+void QTreeViewSortFilterProxyModel::sourceDataChanged(const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
+    if (roles.isEmpty() || roles.contains(filterRole()) || roles.contains(Qt::DisplayRole)) {
+        invalidateMatchCache();
+    }
+}
+
+// Function to get the match state of a node, computing it if needed.
+//
+// The first time a folder is queried, its whole subtree gets evaluated bottom-up and cached, as its visibility depends on it.
+// From there on, any query on that subtree is just a lookup, instead of a new recursion.
+quint8 QTreeViewSortFilterProxyModel::nodeState(int source_row, const QModelIndex &source_parent) const {
     QModelIndex currntIndex = sourceModel()->index(source_row, 0, source_parent);
+    auto cached = match_cache.constFind(currntIndex);
+    if (cached != match_cache.constEnd()) {
+        return cached.value();
+    }
+
+    // Check the current item.
+    bool matches = rowMatches(source_row, source_parent);
+    bool visible = matches;
 
-    // If it has children, is a folder, so check each of his children.
+    // If it has children, is a folder, so check each of his children. We check all of them, so they get cached.
+    // Its own match goes to the cache first, as its files need it.
     if (sourceModel()->hasChildren(currntIndex)) {
-        for (int i = 0; i < sourceModel()->rowCount(currntIndex) && !result; ++i) {
+        match_cache.insert(currntIndex, matches ? NODE_MATCHES : 0);
+        for (int i = 0; i < sourceModel()->rowCount(currntIndex); ++i) {
 
             // Keep the parent if a children is shown.
-            result |= filterAcceptsRow(i, currntIndex);
+            if (nodeState(i, currntIndex) & NODE_VISIBLE) {
+                visible = true;
+            }
         }
     }
 
     // If it's a file, and it's not visible, there is a special behavior:
     // if the parent matches the filter, we assume all it's children do it too.
     // This is to avoid the "Show table folder, no table file" problem.
-    else {
-        result = QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
-        if (!result) {
+    else if (!visible) {
+        if (source_parent.isValid()) {
+            visible = nodeMatches(source_parent);
+        } else {
             QModelIndex granpa = source_parent.parent();
             int granpa_row = source_parent.row();
-            result = QSortFilterProxyModel::filterAcceptsRow(granpa_row, granpa);
+            visible = rowMatches(granpa_row, granpa);
         }
     }
 
-    return result;
+    quint8 state = (matches ? NODE_MATCHES : 0) | (visible ? NODE_VISIBLE : 0);
+    match_cache.insert(currntIndex, state);
+    return state;
+}
+
+// Function to know if a node matches the filter by itself, without caring about its children.
+bool QTreeViewSortFilterProxyModel::nodeMatches(const QModelIndex &source_index) const {
+    auto cached = match_cache.constFind(source_index.sibling(source_index.row(), 0));
+    if (cached != match_cache.constEnd()) {
+        return cached.value() & NODE_MATCHES;
+    }
+
+    return rowMatches(source_index.row(), source_index.parent());
+}
+
+// Function to check a row against the compiled pattern. Like the base class, it checks the filter key column, or all columns if it's -1.
+bool QTreeViewSortFilterProxyModel::rowMatches(int source_row, const QModelIndex &source_parent) const {
+    if (matcher.kind == TreeFilterMatchKind::All) {
+        return true;
+    }
+
+    int role = filterRole();
+    int key_column = filterKeyColumn();
+    if (key_column == -1) {
+        for (int column = 0; column < sourceModel()->columnCount(source_parent); ++column) {
+            if (matcher.matches(sourceModel()->index(source_row, column, source_parent).data(role).toString())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    return matcher.matches(sourceModel()->index(source_row, key_column, source_parent).data(role).toString());
+}
+
+// Function called when the filter changes. Without a filter everything is visible, so the cache is not even touched.
+bool QTreeViewSortFilterProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+    InstrumentationScope scope(InstrumentationProbe::TreeFilterAcceptsRow);
+    if (matcher.kind == TreeFilterMatchKind::All) {
+        return true;
+    }
+
+    return nodeState(source_row, source_parent) & NODE_VISIBLE;
 }
@@ -0,0 +1,67 @@
+#include "trigram_index.h"
+#include <algorithm>
+#include <iterator>
+
+// Function to build the index of a column. It takes the raw texts of the column, delimited by offsets
+// like in the column cache, and folds them itself, so this can run entirely outside the GUI thread.
+TrigramIndex TrigramIndex::build(const QString &text, const QVector<int> &offsets) {
+    TrigramIndex index;
+
+    const int rows = offsets.count() - 1;
+    for (int row = 0; row < rows; ++row) {
+        const int length = offsets.at(row + 1) - offsets.at(row);
+        if (length == 0) {
+            index.blank_rows.append(row);
+            continue;
+        }
+
+        if (length < 3) {
+            continue;
+        }
+
+        const QString folded = text.mid(offsets.at(row), length).toCaseFolded();
+        const QChar *characters = folded.constData();
+        for (int i = 0; i + 3 <= folded.count(); ++i) {
+
+            // Rows are added in order, so checking the last one is enough to keep each list unique.
+            QVector<int> &rows_with_trigram = index.postings[trigram(characters + i)];
+            if (rows_with_trigram.isEmpty() || rows_with_trigram.last() != row) {
+                rows_with_trigram.append(row);
+            }
+        }
+    }
+
+    return index;
+}
+
+// Function to get the sorted list of rows that may contain the provided literal. The literal must be already case-folded.
+QVector<int> TrigramIndex::candidates(const QString &folded_literal) const {
+    QVector<const QVector<int>*> lists;
+    const QChar *characters = folded_literal.constData();
+    for (int i = 0; i + 3 <= folded_literal.count(); ++i) {
+        auto posting = postings.constFind(trigram(characters + i));
+        if (posting == postings.constEnd()) {
+            return QVector<int>();
+        }
+
+        lists.append(&posting.value());
+    }
+
+    if (lists.isEmpty()) {
+        return QVector<int>();
+    }
+
+    // Intersect from the shortest list up, so the intermediate results are as small as possible.
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *left, const QVector<int> *right) {
+        return left->count() < right->count();
+    });
+
+    QVector<int> result = *lists.first();
+    for (int i = 1; i < lists.count() && !result.isEmpty(); ++i) {
+        QVector<int> intersection;
+        std::set_intersection(result.constBegin(), result.constEnd(), lists.at(i)->constBegin(), lists.at(i)->constEnd(), std::back_inserter(intersection));
+        result = intersection;
+    }
+
+    return result;
+}
@@ -143,6 +143,9 @@ pub unsafe fn set_connections(app_ui: &Rc<AppUI>, slots: &AppUISlots) {
     // `Debug` menu connections.
     //-----------------------------------------------//
     app_ui.debug_update_current_schema_from_asskit.triggered().connect(&slots.debug_update_current_schema_from_asskit);
+    app_ui.debug_toggle_instrumentation.toggled().connect(&slots.debug_toggle_instrumentation);
+    app_ui.debug_show_instrumentation.triggered().connect(&slots.debug_show_instrumentation);
+    app_ui.debug_reset_instrumentation.triggered().connect(&slots.debug_reset_instrumentation);
 
     //-----------------------------------------------//
     // `PackedFileView` connections.
@@ -255,6 +255,9 @@ pub struct AppUI {
     // "Debug" menu.
     //-------------------------------------------------------------------------------//
     pub debug_update_current_schema_from_asskit: QPtr<QAction>,
+    pub debug_toggle_instrumentation: QPtr<QAction>,
+    pub debug_show_instrumentation: QPtr<QAction>,
+    pub debug_reset_instrumentation: QPtr<QAction>,
 
     //-------------------------------------------------------------------------------//
     // Extra stuff
@@ -626,6 +629,11 @@ impl AppUI {
 
         // Populate the `Debug` menu.
         let debug_update_current_schema_from_asskit = menu_bar_debug.add_action_q_string(&qtr("update_current_schema_from_asskit"));
+        menu_bar_debug.add_separator();
+        let debug_toggle_instrumentation = menu_bar_debug.add_action_q_string(&qtr("debug_toggle_instrumentation"));
+        let debug_show_instrumentation = menu_bar_debug.add_action_q_string(&qtr("debug_show_instrumentation"));
+        let debug_reset_instrumentation = menu_bar_debug.add_action_q_string(&qtr("debug_reset_instrumentation"));
+        debug_toggle_instrumentation.set_checkable(true);
 
         //-------------------------------------------------------------------------------//
         // "Extra stuff" menu.
@@ -818,6 +826,9 @@ impl AppUI {
             // "Debug" menu.
             //-------------------------------------------------------------------------------//
             debug_update_current_schema_from_asskit,
+            debug_toggle_instrumentation,
+            debug_show_instrumentation,
+            debug_reset_instrumentation,
 
             //-------------------------------------------------------------------------------//
             // "Extra stuff" menu.
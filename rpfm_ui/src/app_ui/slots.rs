@@ -46,6 +46,7 @@ use crate::app_ui::AppUI;
 use crate::CENTRAL_COMMAND;
 use crate::communications::{THREADS_COMMUNICATION_ERROR, Command, Response};
 use crate::diagnostics_ui::DiagnosticsUI;
+use crate::ffi::{get_instrumentation_snapshot_safe, reset_instrumentation_safe, set_instrumentation_enabled_safe};
 use crate::global_search_ui::GlobalSearchUI;
 use crate::locale::{qtr, tr, tre};
 use crate::mymod_ui::MyModUI;
@@ -144,6 +145,9 @@ pub struct AppUISlots {
     // `Debug` menu slots.
     //-----------------------------------------------//
     pub debug_update_current_schema_from_asskit: QBox<SlotOfBool>,
+    pub debug_toggle_instrumentation: QBox<SlotOfBool>,
+    pub debug_show_instrumentation: QBox<SlotOfBool>,
+    pub debug_reset_instrumentation: QBox<SlotOfBool>,
 
     //-----------------------------------------------//
     // `PackedFileView` slots.
@@ -1345,6 +1349,42 @@ impl AppUISlots {
             }
         ));
 
+        // What happens when we toggle the instrumentation of the custom widgets.
+        let debug_toggle_instrumentation = SlotOfBool::new(&app_ui.main_window, |state| {
+            set_instrumentation_enabled_safe(state);
+        });
+
+        // What happens when we want to see what the instrumentation of the custom widgets has recorded.
+        let debug_show_instrumentation = SlotOfBool::new(&app_ui.main_window, clone!(
+            app_ui => move |_| {
+                let snapshot: serde_json::Value = serde_json::from_str(&get_instrumentation_snapshot_safe()).unwrap_or_default();
+                let report = snapshot["probes"].as_array().map(|probes| probes.iter()
+                    .filter(|probe| probe["calls"].as_f64().unwrap_or(0.0) > 0.0)
+                    .map(|probe| format!("{}: {} calls, {:.2} ms total, {:.2} µs mean, {:.2} µs p95, {:.2} µs max",
+                        probe["name"].as_str().unwrap_or_default(),
+                        probe["calls"].as_f64().unwrap_or(0.0),
+                        probe["total_us"].as_f64().unwrap_or(0.0) / 1000.0,
+                        probe["mean_us"].as_f64().unwrap_or(0.0),
+                        probe["p95_us"].as_f64().unwrap_or(0.0),
+                        probe["max_us"].as_f64().unwrap_or(0.0),
+                    ))
+                    .collect::<Vec<String>>()
+                    .join("\n")
+                ).unwrap_or_default();
+
+                if report.is_empty() {
+                    show_dialog(&app_ui.main_window, tr("debug_instrumentation_empty"), true);
+                } else {
+                    show_dialog(&app_ui.main_window, report, true);
+                }
+            }
+        ));
+
+        // What happens when we want to reset what the instrumentation of the custom widgets has recorded.
+        let debug_reset_instrumentation = SlotOfBool::new(&app_ui.main_window, |_| {
+            reset_instrumentation_safe();
+        });
+
         //-----------------------------------------------//
         // `PackedFileView` logic.
         //-----------------------------------------------//
@@ -1372,7 +1412,6 @@ impl AppUISlots {
 
                                 setup_item_delegates(
                                     &table.get_mut_ptr_table_view_primary(),
-                                    &table.get_mut_ptr_table_view_frozen(),
                                     &table.get_ref_table_definition(),
                                     &data,
                                     &table.timer_delayed_updates
@@ -1600,6 +1639,9 @@ impl AppUISlots {
             // `Debug` menu slots.
             //-----------------------------------------------//
             debug_update_current_schema_from_asskit,
+            debug_toggle_instrumentation,
+            debug_show_instrumentation,
+            debug_reset_instrumentation,
 
             //-----------------------------------------------//
             // `PackedFileView` slots.
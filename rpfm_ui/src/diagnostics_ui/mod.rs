@@ -40,7 +40,6 @@ use qt_core::QSortFilterProxyModel;
 use qt_core::QString;
 use qt_core::QVariant;
 use qt_core::QPtr;
-use qt_core::QObject;
 use qt_core::QSignalBlocker;
 
 use cpp_core::CppBox;
@@ -59,7 +58,7 @@ use rpfm_macros::{GetRef, GetRefMut, Set};
 use crate::AppUI;
 use crate::communications::Command;
 use crate::CENTRAL_COMMAND;
-use crate::ffi::{new_tableview_filter_safe, trigger_tableview_filter_safe};
+use crate::ffi::{apply_table_diagnostics_safe, new_tableview_filter_safe, set_filter_debounce_safe, trigger_tableview_filter_safe, CELL_STATUS_ERROR, CELL_STATUS_INFO, CELL_STATUS_WARNING};
 use crate::global_search_ui::GlobalSearchUI;
 use crate::locale::{qtr, qtre, tr};
 use crate::pack_tree::{PackTree, get_color_info, get_color_warning, get_color_error, get_color_info_pressed, get_color_warning_pressed, get_color_error_pressed, TreeViewOperation};
@@ -67,7 +66,6 @@ use crate::packedfile_views::{DataSource, PackedFileView, View, ViewType};
 use crate::packfile_contents_ui::PackFileContentsUI;
 use crate::UI_STATE;
 use crate::utils::create_grid_layout;
-use crate::views::table::{ITEM_HAS_ERROR, ITEM_HAS_WARNING, ITEM_HAS_INFO};
 
 pub mod connections;
 pub mod slots;
@@ -208,6 +206,9 @@ impl DiagnosticsUI {
         let diagnostics_table_model = QStandardItemModel::new_1a(&diagnostics_dock_inner_widget);
         diagnostics_table_filter.set_source_model(&diagnostics_table_model);
         diagnostics_table_view.set_model(&diagnostics_table_filter);
+
+        // Toggling the filter buttons one after another (or all at once) should only filter the table once.
+        set_filter_debounce_safe(&diagnostics_table_filter, 50);
         diagnostics_table_view.set_selection_mode(SelectionMode::ExtendedSelection);
         diagnostics_table_view.set_context_menu_policy(ContextMenuPolicy::CustomContextMenu);
 
@@ -478,9 +479,6 @@ impl DiagnosticsUI {
     /// This function takes care of loading the results of a diagnostic check into the table.
     unsafe fn load_diagnostics_to_ui(app_ui: &Rc<AppUI>, diagnostics_ui: &Rc<Self>, diagnostics: &[DiagnosticType]) {
 
-        // First, clean the current diagnostics.
-        Self::clean_diagnostics_from_views(app_ui);
-
         if !diagnostics.is_empty() {
             let blocker = QSignalBlocker::from_q_object(&diagnostics_ui.diagnostics_table_model);
             for (index, diagnostic_type) in diagnostics.iter().enumerate() {
@@ -725,9 +723,6 @@ impl DiagnosticsUI {
                         }
                     }
                 }
-
-                // After that, check if the table is open, and paint the results into it.
-                Self::paint_diagnostics_to_table(app_ui, diagnostic_type);
             }
 
             diagnostics_ui.diagnostics_table_model.set_header_data_3a(0, Orientation::Horizontal, &QVariant::from_q_string(&qtr("diagnostics_colum_level")));
@@ -746,6 +741,9 @@ impl DiagnosticsUI {
             diagnostics_ui.diagnostics_table_view.horizontal_header().set_stretch_last_section(true);
             diagnostics_ui.diagnostics_table_view.horizontal_header().resize_sections(ResizeMode::ResizeToContents);
         }
+
+        // Paint the results into the open tables, cleaning whatever the previous results painted.
+        Self::paint_diagnostics_to_views(app_ui, diagnostics);
     }
 
     /// This function tries to open the PackedFile where the selected match is.
@@ -871,262 +869,61 @@ impl DiagnosticsUI {
         }
     }
 
-    /// This function tries to paint the results from the provided diagnostics into their file view, if the file is open.
-    pub unsafe fn paint_diagnostics_to_table(
-        app_ui: &Rc<AppUI>,
-        diagnostic: &DiagnosticType,
-    ) {
-
-        let path = match diagnostic {
-            DiagnosticType::AnimFragment(ref diagnostic) => diagnostic.get_path(),
-            DiagnosticType::DB(ref diagnostic) |
-            DiagnosticType::Loc(ref diagnostic) => diagnostic.get_path(),
-            DiagnosticType::DependencyManager(_) => &[],
-            _ => return,
-        };
+    /// This function paints the results from the provided diagnostics into their file views, if the files are open.
+    ///
+    /// Each view gets all its cells in a single batch, replacing what it had painted before, so only the cells that actually changed get updated.
+    /// Views without diagnostics get cleaned.
+    pub unsafe fn paint_diagnostics_to_views(app_ui: &Rc<AppUI>, diagnostics: &[DiagnosticType]) {
+        for view in UI_STATE.get_open_packedfiles().iter().filter(|x| x.get_data_source() == DataSource::PackFile) {
 
-        if let Some(view) = UI_STATE.get_open_packedfiles().iter().filter(|x| x.get_data_source() == DataSource::PackFile).find(|view| view.get_path() == path) {
-            if app_ui.tab_bar_packed_file.index_of(view.get_mut_widget()) != -1 {
-
-                // In case of tables, we have to get the logical row/column of the match and select it.
-                if let ViewType::Internal(View::Table(view)) = view.get_view() {
-                    let table_view = view.get_ref_table().get_mut_ptr_table_view_primary();
-                    let table_filter: QPtr<QSortFilterProxyModel> = table_view.model().static_downcast();
-                    let table_model: QPtr<QStandardItemModel> = table_filter.source_model().static_downcast();
-                    let blocker = QSignalBlocker::from_q_object(table_model.static_upcast::<QObject>());
-
-                    match diagnostic {
-                        DiagnosticType::DB(ref diagnostic) |
-                        DiagnosticType::Loc(ref diagnostic) => {
-                            for result in diagnostic.get_ref_result() {
-                                for (row, column) in &result.cells_affected {
-                                    if *row != -1 || *column != -1 {
-                                        if *column == -1 {
-                                            for column in 0..table_model.column_count_0a() {
-                                                let table_model_index = table_model.index_2a(*row as i32, column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else if *row == -1 {
-                                            for row in 0..table_model.row_count_0a() {
-                                                let table_model_index = table_model.index_2a(row as i32, *column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else {
-                                            let table_model_index = table_model.index_2a(*row as i32, *column as i32);
-                                            let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                            // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                            if table_model_index.is_valid() {
-                                                match result.level {
-                                                    DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                    DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                    DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        },
-                        DiagnosticType::DependencyManager(ref diagnostic) => {
-                            for result in diagnostic.get_ref_result() {
-                                for (row, column) in &result.cells_affected {
-                                    if *row != -1 || *column != -1 {
-
-                                        if *column == -1 {
-                                            for column in 0..table_model.column_count_0a() {
-                                                let table_model_index = table_model.index_2a(*row as i32, column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else if *row == -1 {
-                                            for row in 0..table_model.row_count_0a() {
-                                                let table_model_index = table_model.index_2a(row as i32, *column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else {
-                                            let table_model_index = table_model.index_2a(*row as i32, *column as i32);
-                                            let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                            // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                            if table_model_index.is_valid() {
-                                                match result.level {
-                                                    DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                    DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                    DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        },
-                        _ => return,
-                    }
+            // Only update the visible tables.
+            if app_ui.tab_bar_packed_file.index_of(view.get_mut_widget()) == -1 {
+                continue;
+            }
 
-                    // Unblock the model and update it. Otherwise, the painted cells wont show up until something else updates the view.
-                    blocker.unblock();
-                    table_view.viewport().repaint();
-                }
+            let path = view.get_path();
+            let (table_view, is_anim_fragment) = match view.get_view() {
+                ViewType::Internal(View::Table(view)) => (view.get_ref_table().get_mut_ptr_table_view_primary(), false),
 
                 // AnimFragments have some special logic.
-                else if let ViewType::Internal(View::AnimFragment(view)) = view.get_view() {
-                    let table_view = view.get_ref_table_view_2().get_mut_ptr_table_view_primary();
-                    let table_filter: QPtr<QSortFilterProxyModel> = table_view.model().static_downcast();
-                    let table_model: QPtr<QStandardItemModel> = table_filter.source_model().static_downcast();
-                    let blocker = QSignalBlocker::from_q_object(table_model.static_upcast::<QObject>());
-
-                    match diagnostic {
-                        DiagnosticType::AnimFragment(ref diagnostic) => {
-                            for result in diagnostic.get_ref_result() {
-                                for (row, column) in &result.cells_affected {
-                                    if *row != -1 || *column != -1 {
-                                        if *column == -1 {
-                                            for column in 0..table_model.column_count_0a() {
-                                                let table_model_index = table_model.index_2a(*row as i32, column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else if *row == -1 {
-                                            for row in 0..table_model.row_count_0a() {
-                                                let table_model_index = table_model.index_2a(row as i32, *column as i32);
-                                                let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                                // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                                if table_model_index.is_valid() {
-                                                    match result.level {
-                                                        DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                        DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                        DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                    }
-                                                }
-                                            }
-                                        } else {
-                                            let table_model_index = table_model.index_2a(*row as i32, *column as i32);
-                                            let table_model_item = table_model.item_from_index(&table_model_index);
-
-                                            // At this point, is possible the row is no longer valid, so we have to check it out first.
-                                            if table_model_index.is_valid() {
-                                                match result.level {
-                                                    DiagnosticLevel::Error => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_ERROR),
-                                                    DiagnosticLevel::Warning => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_WARNING),
-                                                    DiagnosticLevel::Info => table_model_item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_INFO),
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        },
-                        _ => return,
+                ViewType::Internal(View::AnimFragment(view)) => (view.get_ref_table_view_2().get_mut_ptr_table_view_primary(), true),
+                _ => continue,
+            };
+
+            // Cells are sent as (row, column, flags), with the same flags the cells use for their status.
+            let mut cells = vec![];
+            let mut add_cells = |cells_affected: &[(i32, i32)], level: &DiagnosticLevel| {
+                let flags = match level {
+                    DiagnosticLevel::Error => CELL_STATUS_ERROR,
+                    DiagnosticLevel::Warning => CELL_STATUS_WARNING,
+                    DiagnosticLevel::Info => CELL_STATUS_INFO,
+                };
+
+                for (row, column) in cells_affected {
+                    if *row != -1 || *column != -1 {
+                        cells.push((*row, *column, flags));
                     }
-
-                    // Unblock the model and update it. Otherwise, the painted cells wont show up until something else updates the view.
-                    blocker.unblock();
-                    table_view.viewport().repaint();
                 }
-            }
-        }
-    }
-
-    pub unsafe fn clean_diagnostics_from_views(app_ui: &Rc<AppUI>) {
-        for view in UI_STATE.get_open_packedfiles().iter().filter(|x| x.get_data_source() == DataSource::PackFile) {
-
-            // Only update the visible tables.
-            if app_ui.tab_bar_packed_file.index_of(view.get_mut_widget()) != -1 {
-
-                // In case of tables, we have to get the logical row/column of the match and select it.
-                if let ViewType::Internal(View::Table(view)) = view.get_view() {
-                    let table_view = view.get_ref_table().get_mut_ptr_table_view_primary();
-                    let table_filter: QPtr<QSortFilterProxyModel> = table_view.model().static_downcast();
-                    let table_model: QPtr<QStandardItemModel> = table_filter.source_model().static_downcast();
-                    let blocker = QSignalBlocker::from_q_object(table_model.static_upcast::<QObject>());
+            };
 
-                    for row in 0..table_model.row_count_0a() {
-                        for column in 0..table_model.column_count_0a() {
-                            let item = table_model.item_2a(row, column);
-
-                            if item.data_1a(ITEM_HAS_ERROR).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_ERROR);
-                            }
-                            if item.data_1a(ITEM_HAS_WARNING).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_WARNING);
-                            }
-                            if item.data_1a(ITEM_HAS_INFO).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_INFO);
-                            }
-                        }
-                    }
-                    blocker.unblock();
-                    table_view.viewport().repaint();
-                } else if let ViewType::Internal(View::AnimFragment(view)) = view.get_view() {
-                    let table_view = view.get_ref_table_view_2().get_mut_ptr_table_view_primary();
-                    let table_filter: QPtr<QSortFilterProxyModel> = table_view.model().static_downcast();
-                    let table_model: QPtr<QStandardItemModel> = table_filter.source_model().static_downcast();
-                    let blocker = QSignalBlocker::from_q_object(table_model.static_upcast::<QObject>());
-
-                    for row in 0..table_model.row_count_0a() {
-                        for column in 0..table_model.column_count_0a() {
-                            let item = table_model.item_2a(row, column);
-
-                            if item.data_1a(ITEM_HAS_ERROR).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_ERROR);
-                            }
-                            if item.data_1a(ITEM_HAS_WARNING).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_WARNING);
-                            }
-                            if item.data_1a(ITEM_HAS_INFO).to_bool() == true {
-                                item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_INFO);
-                            }
-                        }
-                    }
-                    blocker.unblock();
-                    table_view.viewport().repaint();
+            for diagnostic in diagnostics {
+                match diagnostic {
+                    DiagnosticType::DB(ref diagnostic) |
+                    DiagnosticType::Loc(ref diagnostic) => if !is_anim_fragment && diagnostic.get_path() == &path[..] {
+                        diagnostic.get_ref_result().iter().for_each(|result| add_cells(&result.cells_affected, &result.level));
+                    },
+                    DiagnosticType::DependencyManager(ref diagnostic) => if !is_anim_fragment && path.is_empty() {
+                        diagnostic.get_ref_result().iter().for_each(|result| add_cells(&result.cells_affected, &result.level));
+                    },
+                    DiagnosticType::AnimFragment(ref diagnostic) => if is_anim_fragment && diagnostic.get_path() == &path[..] {
+                        diagnostic.get_ref_result().iter().for_each(|result| add_cells(&result.cells_affected, &result.level));
+                    },
+                    _ => {},
                 }
             }
+
+            let table_filter: QPtr<QSortFilterProxyModel> = table_view.model().static_downcast();
+            apply_table_diagnostics_safe(&table_filter.source_model(), &cells, true);
         }
     }
 
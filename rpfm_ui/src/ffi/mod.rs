@@ -18,18 +18,18 @@ use qt_widgets::{QMessageBox, q_message_box};
 use qt_widgets::QTableView;
 use qt_widgets::QWidget;
 
+use qt_gui::QIcon;
 #[cfg(feature = "support_modern_dds")]
 use qt_gui::QImage;
 use qt_gui::QPixmap;
+use qt_gui::QStandardItem;
 use qt_gui::QStandardItemModel;
 
-#[cfg(any(feature = "support_rigidmodel", feature = "support_modern_dds"))]
 use qt_core::QByteArray;
 
 use qt_core::QAbstractItemModel;
 use qt_core::QBox;
 use qt_core::QObject;
-use qt_core::QRegExp;
 use qt_core::QSortFilterProxyModel;
 use qt_core::QString;
 use qt_core::QStringList;
@@ -41,13 +41,14 @@ use qt_core::CaseSensitivity;
 #[cfg(feature = "support_rigidmodel")]
 use cpp_core::CppBox;
 use cpp_core::Ptr;
+use cpp_core::Ref;
 
 #[cfg(feature = "support_rigidmodel")]
 use rpfm_error::{Result, ErrorKind};
 
 use rpfm_lib::SETTINGS;
 
-use crate::locale::qtr;
+use crate::locale::{qtr, tre};
 use crate::UI_STATE;
 
 //---------------------------------------------------------------------------//
@@ -62,6 +63,26 @@ pub fn new_combobox_item_delegate_safe(table_view: &Ptr<QObject>, column: i32, l
     unsafe { new_combobox_item_delegate(table_view.as_mut_raw_ptr(), column, list.as_raw_ptr(), is_editable, max_lenght, timer.as_mut_raw_ptr(), is_dark_theme_enabled, has_filter, is_right_side_mark_enabled) }
 }
 
+/// This function replaces the default editor widget for reference columns with a combobox, using a list of the reference list registry.
+extern "C" { fn new_combobox_item_delegate_shared(table_view: *mut QObject, column: i32, reference_list: i32, is_editable: bool, max_lenght: i32, timer: *mut QTimer, is_dark_theme_enabled: bool, has_filter: bool, is_right_side_mark_enabled: bool); }
+pub fn new_combobox_item_delegate_shared_safe(table_view: &Ptr<QObject>, column: i32, reference_list: i32, is_editable: bool, max_lenght: i32, timer: &Ptr<QTimer>, has_filter: bool) {
+    let is_dark_theme_enabled = SETTINGS.read().unwrap().settings_bool["use_dark_theme"];
+    let is_right_side_mark_enabled = SETTINGS.read().unwrap().settings_bool["use_right_size_markers"];
+    unsafe { new_combobox_item_delegate_shared(table_view.as_mut_raw_ptr(), column, reference_list, is_editable, max_lenght, timer.as_mut_raw_ptr(), is_dark_theme_enabled, has_filter, is_right_side_mark_enabled) }
+}
+
+/// This function returns the handle of a list of the reference list registry, if it's registered with the provided version. Otherwise, it returns -1.
+extern "C" { fn reference_list_find(key: *const QString, version: u64) -> i32; }
+pub fn reference_list_find_safe(key: &Ptr<QString>, version: u64) -> i32 {
+    unsafe { reference_list_find(key.as_raw_ptr(), version) }
+}
+
+/// This function registers a list in the reference list registry, replacing any older version of it, and returns its handle.
+extern "C" { fn reference_list_register(key: *const QString, version: u64, values: *const QStringList) -> i32; }
+pub fn reference_list_register_safe(key: &Ptr<QString>, version: u64, values: &Ptr<QStringList>) -> i32 {
+    unsafe { reference_list_register(key.as_raw_ptr(), version, values.as_raw_ptr()) }
+}
+
 /// This function changes the default editor widget for I32/64 cells on tables with a numeric one.
 extern "C" { fn new_spinbox_item_delegate(table_view: *mut QObject, column: i32, integer_type: i32, timer: *mut QTimer, is_dark_theme_enabled: bool, has_filter: bool, is_right_side_mark_enabled: bool); }
 pub fn new_spinbox_item_delegate_safe(table_view: &Ptr<QObject>, column: i32, integer_type: i32, timer: &Ptr<QTimer>, has_filter: bool) {
@@ -94,6 +115,12 @@ pub fn new_generic_item_delegate_safe(table_view: &Ptr<QObject>, column: i32, ti
     unsafe { new_generic_item_delegate(table_view.as_mut_raw_ptr(), column, timer.as_mut_raw_ptr(), is_dark_theme_enabled, has_filter, is_right_side_mark_enabled) }
 }
 
+/// This function makes the delegates reload their colours from the settings. Call it after changing them.
+extern "C" { fn invalidate_theme_palette(); }
+pub fn invalidate_theme_palette_safe() {
+    unsafe { invalidate_theme_palette() }
+}
+
 /// This function setup the special filter used for the PackFile Contents `TreeView`.
 extern "C" { fn new_treeview_filter(parent: *mut QObject) -> *mut QSortFilterProxyModel; }
 pub fn new_treeview_filter_safe(parent: QPtr<QObject>) ->  QBox<QSortFilterProxyModel> {
@@ -101,9 +128,46 @@ pub fn new_treeview_filter_safe(parent: QPtr<QObject>) ->  QBox<QSortFilterProxy
 }
 
 /// This function triggers the special filter used for the PackFile Contents `TreeView`. It has to be triggered here to work properly.
-extern "C" { fn trigger_treeview_filter(filter: *const QSortFilterProxyModel, pattern: *mut QRegExp); }
-pub fn trigger_treeview_filter_safe(filter: &QSortFilterProxyModel, pattern: &Ptr<QRegExp>) {
-    unsafe { trigger_treeview_filter(filter, pattern.as_mut_raw_ptr()); }
+///
+/// The pattern is compiled once on the C++ side, skipping the regex engine if it's a plain literal.
+extern "C" { fn trigger_treeview_filter_pattern(filter: *const QSortFilterProxyModel, pattern: *mut QString, flags: i32); }
+pub fn trigger_treeview_filter_safe(filter: &QSortFilterProxyModel, pattern: &Ptr<QString>, case_sensitive: bool) {
+    // Bit 0 of the flags is the case sensitivity (TREEVIEW_FILTER_CASE_SENSITIVE on the C++ side).
+    let flags = if case_sensitive { 1 } else { 0 };
+    unsafe { trigger_treeview_filter_pattern(filter, pattern.as_mut_raw_ptr(), flags); }
+}
+
+/// This function loads an entire table into the provided model in one go, from a buffer packed with `get_packed_table_data`.
+extern "C" { fn load_table_data(model: *mut QAbstractItemModel, buffer: *const u8, buffer_size: i64, rows: i32, column_types: *const QListOfInt, key_columns: *const QListOfInt, editable: bool, tooltip_template: *const QString, sequence_text: *const QString); }
+pub unsafe fn load_table_data_safe(model: &QPtr<QStandardItemModel>, buffer: &[u8], rows: i32, column_types: &[i32], key_columns: &[i32], editable: bool) {
+    let column_types_qlist = QListOfInt::new();
+    column_types.iter().for_each(|x| column_types_qlist.append_int(x));
+
+    let key_columns_qlist = QListOfInt::new();
+    key_columns.iter().for_each(|x| key_columns_qlist.append_int(x));
+
+    let tooltip_template = QString::from_std_str(&tre("original_data", &["%1"]));
+    let sequence_text = qtr("packedfile_editable_sequence");
+
+    load_table_data(model.static_upcast::<QAbstractItemModel>().as_mut_raw_ptr(), buffer.as_ptr(), buffer.len() as i64, rows, column_types_qlist.into_ptr().as_raw_ptr(), key_columns_qlist.into_ptr().as_raw_ptr(), editable, tooltip_template.as_ptr().as_raw_ptr(), sequence_text.as_ptr().as_raw_ptr())
+}
+
+/// Status flags of the diagnostics of a cell, as `apply_table_diagnostics` expects them.
+pub const CELL_STATUS_ERROR: i32 = 8;
+pub const CELL_STATUS_WARNING: i32 = 16;
+pub const CELL_STATUS_INFO: i32 = 32;
+
+/// This function applies the provided (row, column, flags) diagnostics to a table model, only updating the cells that change.
+///
+/// A row of -1 means the entire column, and a column of -1 the entire row. If `replace` is true, the cells not provided get their diagnostics cleaned.
+extern "C" { fn apply_table_diagnostics(model: *mut QAbstractItemModel, cells: *const i32, count: i32, replace: bool); }
+pub unsafe fn apply_table_diagnostics_safe(model: &QPtr<QAbstractItemModel>, cells: &[(i32, i32, i32)], replace: bool) {
+    let mut cells_flat = Vec::with_capacity(cells.len() * 3);
+    for (row, column, flags) in cells {
+        cells_flat.extend_from_slice(&[*row, *column, *flags]);
+    }
+
+    apply_table_diagnostics(model.as_mut_raw_ptr(), cells_flat.as_ptr(), cells.len() as i32, replace)
 }
 
 /// This function setup the special filter used for the TableViews.
@@ -133,6 +197,18 @@ pub unsafe fn trigger_tableview_filter_safe(filter: &QSortFilterProxyModel, colu
     trigger_tableview_filter(filter, columns_qlist.into_ptr().as_raw_ptr(), patterns_qlist.into_ptr().as_raw_ptr(), case_sensitive_qlist.into_ptr().as_raw_ptr(), show_blank_cells_qlist.into_ptr().as_raw_ptr(), match_groups_qlist.into_ptr().as_raw_ptr());
 }
 
+/// This function enables/disables the trigram index of the special filter used for the TableViews. Only worth it on big tables.
+extern "C" { fn set_tableview_filter_trigram_index(filter: *const QSortFilterProxyModel, enabled: bool); }
+pub fn set_tableview_filter_trigram_index_safe(filter: &QSortFilterProxyModel, enabled: bool) {
+    unsafe { set_tableview_filter_trigram_index(filter, enabled); }
+}
+
+/// This function sets how long (in ms) the special filters used for the TableViews and TreeViews wait for more changes before filtering. 0 means they filter right away.
+extern "C" { fn set_filter_debounce(filter: *mut QObject, msec: i32); }
+pub fn set_filter_debounce_safe(filter: &QBox<QSortFilterProxyModel>, msec: i32) {
+    unsafe { set_filter_debounce(filter.static_upcast::<QObject>().as_mut_raw_ptr(), msec); }
+}
+
 
 /// This function allow us to create a model compatible with draggable items
 extern "C" { fn new_packed_file_model() -> *mut QStandardItemModel; }
@@ -140,6 +216,34 @@ pub fn new_packed_file_model_safe() -> QBox<QStandardItemModel> {
     unsafe { QBox::from_raw(new_packed_file_model()) }
 }
 
+/// This function loads lazily the PackedFiles of a PackFile under its root item, from a buffer packed with their sorted paths, tooltips and icon ids.
+///
+/// It returns false if the model doesn't support lazy loading, so the items have to be built by hand.
+extern "C" { fn packed_file_model_load_lazy(model: *mut QStandardItemModel, root: *mut QStandardItem, buffer: *const u8, buffer_size: i64, count: i32) -> bool; }
+pub unsafe fn packed_file_model_load_lazy_safe(model: &QPtr<QStandardItemModel>, root: Ptr<QStandardItem>, buffer: &[u8], count: i32) -> bool {
+    packed_file_model_load_lazy(model.as_mut_raw_ptr(), root.as_mut_raw_ptr(), buffer.as_ptr(), buffer.len() as i64, count)
+}
+
+/// This function registers one of the icons used by the items of a lazy PackFile tree. The id 0 is for folders.
+extern "C" { fn packed_file_model_register_icon(model: *mut QStandardItemModel, id: i32, icon: *const QIcon); }
+pub unsafe fn packed_file_model_register_icon_safe(model: &QPtr<QStandardItemModel>, id: i32, icon: Ref<QIcon>) {
+    packed_file_model_register_icon(model.as_mut_raw_ptr(), id, icon.as_raw_ptr())
+}
+
+/// This function makes sure all the items of a path exist in a lazy PackFile tree, so we can walk down to it.
+extern "C" { fn packed_file_model_fetch_path(model: *mut QStandardItemModel, path: *const QStringList); }
+pub unsafe fn packed_file_model_fetch_path_safe(model: &QPtr<QStandardItemModel>, path: &[String]) {
+    let path_qlist = QStringList::new();
+    path.iter().for_each(|x| path_qlist.append_q_string(&QString::from_std_str(x)));
+    packed_file_model_fetch_path(model.as_mut_raw_ptr(), path_qlist.as_ptr().as_raw_ptr())
+}
+
+/// This function makes sure all the items under the provided one exist in a lazy PackFile tree.
+extern "C" { fn packed_file_model_fetch_all(model: *mut QStandardItemModel, item: *mut QStandardItem); }
+pub unsafe fn packed_file_model_fetch_all_safe(model: &QPtr<QStandardItemModel>, item: Ptr<QStandardItem>) {
+    packed_file_model_fetch_all(model.as_mut_raw_ptr(), item.as_mut_raw_ptr())
+}
+
 /// This function allow us to create a custom window.
 extern "C" { fn new_q_main_window_custom(are_you_sure: extern fn(*mut QMainWindow, bool) -> bool) -> *mut QMainWindow; }
 pub fn new_q_main_window_custom_safe(are_you_sure: extern fn(*mut QMainWindow, bool) -> bool) -> QBox<QMainWindow> {
@@ -159,6 +263,19 @@ pub fn new_tableview_frozen_safe(parent: &Ptr<QWidget>) -> (QBox<QTableView>, QB
     unsafe { (QBox::from_raw(table_view_normal), QBox::from_raw(table_view_frozen)) }
 }
 
+/// This function makes the frozen view of a table capable of freezing columns use the same delegates as the primary one.
+/// Call it after changing the delegates of the primary view.
+extern "C" { fn share_frozen_delegates(table: *mut QTableView); }
+pub fn share_frozen_delegates_safe(table: &Ptr<QTableView>) {
+    unsafe { share_frozen_delegates(table.as_mut_raw_ptr()) };
+}
+
+/// This function makes all the rows of a table capable of freezing columns the same height. A height of 0 uses the default one.
+extern "C" { fn set_uniform_row_height(table: *mut QTableView, height: i32); }
+pub fn set_uniform_row_height_safe(table: &Ptr<QTableView>, height: i32) {
+    unsafe { set_uniform_row_height(table.as_mut_raw_ptr(), height) };
+}
+
 /// This function allows you to load data to a table capable of freezing columns.
 extern "C" { fn set_data_model(table: *mut QTableView, model: *mut QAbstractItemModel); }
 pub fn set_frozen_data_model_safe(table: &Ptr<QTableView>, model: &Ptr<QAbstractItemModel>) {
@@ -181,16 +298,50 @@ pub fn new_text_editor_safe(parent: &QPtr<QWidget>) -> QBox<QWidget> {
     unsafe { QBox::from_raw(new_text_editor(parent.as_mut_raw_ptr())) }
 }
 
-/// This function allow us to get the text from the provided KTextEditor.
-extern "C" { fn get_text(document: *mut QWidget) -> *mut QString; }
-pub fn get_text_safe(document: &QBox<QWidget>) -> Ptr<QString> {
-    unsafe { Ptr::from_raw(get_text(document.as_mut_raw_ptr())) }
+/// This function allow us to set the text of the provided KTextEditor straight from a str, without building a QString first.
+extern "C" { fn set_text_utf8(document: *mut QWidget, text: *const u8, length: i64, highlighting_mode: *mut QString); }
+pub fn set_text_utf8_safe(document: &QBox<QWidget>, text: &str, highlighting_mode: &Ptr<QString>) {
+    unsafe { set_text_utf8(document.as_mut_raw_ptr(), text.as_ptr(), text.len() as i64, highlighting_mode.as_mut_raw_ptr()) }
 }
 
-/// This function allow us to set the text of  the provided KTextEditor.
-extern "C" { fn set_text(document: *mut QWidget, string: *mut QString, highlighting_mode: *mut QString); }
-pub fn set_text_safe(document: &QBox<QWidget>, string: &Ptr<QString>, highlighting_mode: &Ptr<QString>) {
-    unsafe { set_text(document.as_mut_raw_ptr(), string.as_mut_raw_ptr(), highlighting_mode.as_mut_raw_ptr()) }
+/// This function allow us to get the text from the provided KTextEditor as a String, converting it only once.
+extern "C" { fn get_text_utf8(document: *mut QWidget, buffer: *mut QByteArray); }
+pub fn get_text_utf8_safe(document: &QBox<QWidget>) -> String {
+    unsafe {
+        let buffer = QByteArray::new();
+        get_text_utf8(document.as_mut_raw_ptr(), buffer.as_mut_raw_ptr());
+        let data = std::slice::from_raw_parts(buffer.data() as *const u8, buffer.length() as usize);
+        String::from_utf8_lossy(data).into_owned()
+    }
+}
+
+/// This function returns the lines changed in the provided KTextEditor since its text was set, if any.
+///
+/// The tuple contains the first changed line, the last line of the original text they replace, and the changed lines joined with `\n`.
+extern "C" { fn get_modified_text(document: *mut QWidget, first_line: *mut i32, original_last_line: *mut i32, text: *mut QString) -> bool; }
+pub fn get_modified_text_safe(document: &QBox<QWidget>) -> Option<(usize, usize, String)> {
+    unsafe {
+        let mut first_line = 0;
+        let mut original_last_line = 0;
+        let text = QString::new();
+        if get_modified_text(document.as_mut_raw_ptr(), &mut first_line, &mut original_last_line, text.as_mut_raw_ptr()) {
+            Some((first_line as usize, original_last_line as usize, text.to_std_string()))
+        } else {
+            None
+        }
+    }
+}
+
+/// This function marks the current text of the provided KTextEditor as unmodified, so only later changes are returned by `get_modified_text_safe`.
+extern "C" { fn reset_modified_text(document: *mut QWidget); }
+pub fn reset_modified_text_safe(document: &QBox<QWidget>) {
+    unsafe { reset_modified_text(document.as_mut_raw_ptr()) }
+}
+
+/// This function makes big texts stay read-only and without highlighting on the provided KTextEditor, so they open as fast as possible.
+extern "C" { fn set_text_editor_large_file_read_only(document: *mut QWidget, read_only: bool); }
+pub fn set_text_editor_large_file_read_only_safe(document: &QBox<QWidget>, read_only: bool) {
+    unsafe { set_text_editor_large_file_read_only(document.as_mut_raw_ptr(), read_only) }
 }
 
 /// This function triggers the config dialog for the KTextEditor.
@@ -261,6 +412,32 @@ pub fn set_rigid_model_view_safe(parent: &Ptr<QWidget>, data: &Ptr<QByteArray>)
     }
 }
 
+//---------------------------------------------------------------------------//
+// Instrumentation stuff.
+//---------------------------------------------------------------------------//
+
+/// This function turns on or off the timers and counters of the hot paths of the custom widgets. They're off by default.
+extern "C" { fn set_instrumentation_enabled(enabled: bool); }
+pub fn set_instrumentation_enabled_safe(enabled: bool) {
+    unsafe { set_instrumentation_enabled(enabled) }
+}
+
+/// This function returns the counters of the hot paths of the custom widgets, as JSON.
+extern "C" { fn get_instrumentation_snapshot(snapshot: *mut QString); }
+pub fn get_instrumentation_snapshot_safe() -> String {
+    unsafe {
+        let snapshot = QString::new();
+        get_instrumentation_snapshot(snapshot.as_mut_raw_ptr());
+        snapshot.to_std_string()
+    }
+}
+
+/// This function resets the counters of the hot paths of the custom widgets.
+extern "C" { fn reset_instrumentation(); }
+pub fn reset_instrumentation_safe() {
+    unsafe { reset_instrumentation() }
+}
+
 //---------------------------------------------------------------------------//
 // Special functions.
 //---------------------------------------------------------------------------//
@@ -36,8 +36,7 @@ use qt_core::QPtr;
 use qt_core::QFlags;
 use qt_core::QModelIndex;
 use qt_core::q_item_selection_model::SelectionFlag;
-use qt_core::{CaseSensitivity, DockWidgetArea, Orientation, SortOrder};
-use qt_core::QRegExp;
+use qt_core::{DockWidgetArea, Orientation, SortOrder};
 use qt_core::QSortFilterProxyModel;
 use qt_core::QVariant;
 
@@ -874,15 +873,13 @@ impl GlobalSearchUI {
         case_sensitive_button: &QBox<QPushButton>,
     ) {
 
-        let pattern = QRegExp::new_1a(&line_edit.text());
+        let pattern = line_edit.text();
 
         let case_sensitive = case_sensitive_button.is_checked();
-        if case_sensitive { pattern.set_case_sensitivity(CaseSensitivity::CaseSensitive); }
-        else { pattern.set_case_sensitivity(CaseSensitivity::CaseInsensitive); }
 
         let model_filter: QPtr<QSortFilterProxyModel> = view.model().static_downcast();
         model_filter.set_filter_key_column(column_combobox.current_index());
-        trigger_treeview_filter_safe(&model_filter, &pattern.as_ptr());
+        trigger_treeview_filter_safe(&model_filter, &pattern.as_ptr(), case_sensitive);
     }
 
     /// Function to get all the selected matches in the visible selection.
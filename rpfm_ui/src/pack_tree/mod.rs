@@ -17,6 +17,7 @@ use qt_widgets::q_header_view::ResizeMode;
 
 use qt_gui::QBrush;
 use qt_gui::QColor;
+use qt_gui::QIcon;
 use qt_gui::QStandardItem;
 use qt_gui::QStandardItemModel;
 use qt_gui::QListOfQStandardItem;
@@ -53,6 +54,7 @@ use rpfm_lib::SUPPORTED_GAMES;
 
 use crate::CENTRAL_COMMAND;
 use crate::communications::{Command, Response, THREADS_COMMUNICATION_ERROR};
+use crate::ffi::{packed_file_model_fetch_all_safe, packed_file_model_fetch_path_safe, packed_file_model_load_lazy_safe, packed_file_model_register_icon_safe};
 use crate::pack_tree::icons::IconType;
 use crate::packfile_contents_ui::PackFileContentsUI;
 use crate::{
@@ -300,8 +302,9 @@ impl PackTree for QBox<QTreeView> {
 
     unsafe fn add_row_to_path(row: Ptr<QListOfQStandardItem>, model: &QPtr<QStandardItemModel>, path: &[String], packed_file_info: &Option<PackedFileInfo>) {
 
-        // First, we go down the tree to the row we have to take.
+        // First, we go down the tree to the row we have to take. If the tree is lazy, make sure its folders exist.
         let type_to_skip = if row.value_1a(0).data_1a(ITEM_TYPE).to_int_0a() == ITEM_TYPE_FILE { ITEM_TYPE_FOLDER } else { ITEM_TYPE_FILE };
+        packed_file_model_fetch_path_safe(model, path);
         let mut item = model.item_1a(0);
         let item_status = get_status_item_from_item(item);
         item_status.set_data_2a(&QVariant::from_int(ITEM_STATUS_MODIFIED), ITEM_STATUS);
@@ -372,6 +375,7 @@ impl PackTree for QBox<QTreeView> {
         let model: QPtr<QStandardItemModel> = filter.source_model().static_downcast();
 
         // Get the first item's index, as that one should always exist (the Packfile).
+        packed_file_model_fetch_path_safe(&model, path);
         let mut item = model.item_1a(0);
         let model_index = model.index_2a(0, 0);
         let filtered_index = filter.map_from_source(&model_index);
@@ -450,7 +454,11 @@ impl PackTree for QBox<QTreeView> {
         let filter: QPtr<QSortFilterProxyModel> = tree_view.model().static_downcast();
         let model: QPtr<QStandardItemModel> = filter.source_model().static_downcast();
 
-        // First, expand our item, then expand its children.
+        // First, expand our item, then expand its children. On lazy trees, we need to create them all first.
+        if first_item {
+            packed_file_model_fetch_all_safe(&model, item);
+        }
+
         let model_index = model.index_from_item(item);
         if first_item {
             let filtered_index = filter.map_from_source(&model_index);
@@ -527,6 +535,7 @@ impl PackTree for QBox<QTreeView> {
                  TreePathType::File(_) => item_types.push(item_type.clone()),
                  TreePathType::Folder(_) | TreePathType::PackFile => {
                     let item = <QBox<QTreeView> as PackTree>::get_item_from_type(&item_type, &model);
+                    packed_file_model_fetch_all_safe(&model, item);
                     get_visible_childs_of_item(&item, self, &filter, &model, &mut item_types);
                  }
                  TreePathType::None => unreachable!(),
@@ -542,6 +551,7 @@ impl PackTree for QBox<QTreeView> {
         let mut item = model.item_1a(0);
         match item_type {
             TreePathType::File(ref path) | TreePathType::Folder(ref path) => {
+                packed_file_model_fetch_path_safe(model, path);
                 let mut index = 0;
                 let path_deep = path.len();
                 loop {
@@ -748,6 +758,7 @@ impl PackTree for QBox<QTreeView> {
 
                 // First, we go down the tree to the row we have to take.
                 let is_file = matches!(item_type, TreePathType::File(_));
+                packed_file_model_fetch_path_safe(model, path);
                 let mut item = model.item_1a(0);
                 let item_status = get_status_item_from_item(item);
                 item_status.set_data_2a(&QVariant::from_int(ITEM_STATUS_MODIFIED), ITEM_STATUS);
@@ -827,7 +838,7 @@ impl PackTree for QBox<QTreeView> {
                 let tooltip = new_pack_file_tooltip(&pack_file_data);
                 big_parent.set_tool_tip(&QString::from_std_str(tooltip));
                 big_parent.set_editable(false);
-                big_parent.set_data_2a(&QVariant::from_int(ITEM_TYPE_PACKFILE), ITEM_TYPE);
+                set_item_type(&big_parent, ITEM_TYPE_PACKFILE);
                 state_item.set_data_2a(&QVariant::from_int(ITEM_STATUS_PRISTINE), ITEM_STATUS);
                 state_item.set_editable(false);
                 let flags = ItemFlag::from(state_item.flags().to_int() & ItemFlag::ItemIsSelectable.to_int());
@@ -890,88 +901,91 @@ impl PackTree for QBox<QTreeView> {
                     }
                 });
 
-                // Once we get the entire path list sorted, we add the paths to the model one by one,
-                // skipping duplicate entries.
-                for packed_file in &sorted_path_list {
-
-                    // First, we reset the parent to the big_parent (the PackFile).
-                    // Then, we form the path ("parent -> child" style path) to add to the model.
-                    let mut parent = big_parent.as_ptr();
-                    for (index_in_path, name) in packed_file.path.iter().enumerate() {
-                        let name = QString::from_std_str(name);
-
-                        // If it's the last string in the file path, it's a file, so we add it to the model.
-                        if index_in_path == packed_file.path.len() - 1 {
-                            let file = QStandardItem::from_q_string(&name);
-                            let state_item = QStandardItem::new();
-                            let tooltip = new_packed_file_tooltip(&packed_file);
-                            file.set_tool_tip(&QString::from_std_str(tooltip));
-                            file.set_editable(false);
-                            file.set_data_2a(&QVariant::from_int(ITEM_TYPE_FILE), ITEM_TYPE);
-                            state_item.set_data_2a(&QVariant::from_int(ITEM_STATUS_PRISTINE), ITEM_STATUS);
-                            state_item.set_editable(false);
-                            state_item.set_flags(QFlags::from(flags));
-                            let icon_type = IconType::File(packed_file.path.to_vec());
-                            icon_type.set_icon_to_item_safe(&file);
-
-                            let qlist = QListOfQStandardItem::new();
-                            qlist.append_q_standard_item(&file.into_ptr().as_mut_raw_ptr());
-                            qlist.append_q_standard_item(&state_item.into_ptr().as_mut_raw_ptr());
-
-                            parent.append_row_q_list_of_q_standard_item(qlist.as_ref());
-                        }
-
-                        // If it's a folder, we check first if it's already in the TreeView using the following
-                        // logic:
-                        // - If the current parent has a child, it should be a folder already in the TreeView,
-                        //   so we check all his children.
-                        // - If any of them is equal to the current folder we are trying to add and it has at
-                        //   least one child, it's a folder exactly like the one we are trying to add, so that
-                        //   one becomes our new parent.
-                        // - If there is no equal folder to the one we are trying to add, we add it, turn it
-                        //   into the new parent, and repeat.
-                        else {
-
-                            // If the current parent has at least one child, check if the folder already exists.
-                            let mut duplicate_found = false;
-                            if parent.has_children() {
-
-                                // It's a folder, so we check his children. We are only interested in
-                                // folders, so ignore the files. Reverse because due to the sorting it's almost
-                                // sure the last folder is the one we want.
-                                for index in (0..parent.row_count()).rev() {
-                                    let child = parent.child_2a(index, 0);
-                                    if child.data_1a(ITEM_TYPE).to_int_0a() == ITEM_TYPE_FILE { continue }
-
-                                    // Get his text. If it's the same folder we are trying to add, this is our parent now.
-                                    if child.text().compare_q_string(&name) == 0 {
-                                        parent = parent.child_1a(index);
-                                        duplicate_found = true;
-                                        break;
-                                    }
-                                }
-                            }
-
-                            // If our current parent doesn't have anything, just add it as a new folder.
-                            if !duplicate_found {
-                                let folder = QStandardItem::from_q_string(&name);
+                // Once we get the entire path list sorted, if the model supports it, we leave the items to be created when they're needed.
+                // Otherwise, we add the paths to the model one by one, skipping duplicate entries.
+                let is_lazy = load_lazy_tree(&model, big_parent.as_ptr(), &sorted_path_list);
+                if !is_lazy {
+                    for packed_file in &sorted_path_list {
+
+                        // First, we reset the parent to the big_parent (the PackFile).
+                        // Then, we form the path ("parent -> child" style path) to add to the model.
+                        let mut parent = big_parent.as_ptr();
+                        for (index_in_path, name) in packed_file.path.iter().enumerate() {
+                            let name = QString::from_std_str(name);
+
+                            // If it's the last string in the file path, it's a file, so we add it to the model.
+                            if index_in_path == packed_file.path.len() - 1 {
+                                let file = QStandardItem::from_q_string(&name);
                                 let state_item = QStandardItem::new();
-                                folder.set_editable(false);
-                                folder.set_data_2a(&QVariant::from_int(ITEM_TYPE_FOLDER), ITEM_TYPE);
+                                let tooltip = new_packed_file_tooltip(&packed_file);
+                                file.set_tool_tip(&QString::from_std_str(tooltip));
+                                file.set_editable(false);
+                                set_item_type(&file, ITEM_TYPE_FILE);
                                 state_item.set_data_2a(&QVariant::from_int(ITEM_STATUS_PRISTINE), ITEM_STATUS);
                                 state_item.set_editable(false);
                                 state_item.set_flags(QFlags::from(flags));
-                                let icon_type = IconType::Folder;
-                                icon_type.set_icon_to_item_safe(&folder);
+                                let icon_type = IconType::File(packed_file.path.to_vec());
+                                icon_type.set_icon_to_item_safe(&file);
 
                                 let qlist = QListOfQStandardItem::new();
-                                qlist.append_q_standard_item(&folder.into_ptr().as_mut_raw_ptr());
+                                qlist.append_q_standard_item(&file.into_ptr().as_mut_raw_ptr());
                                 qlist.append_q_standard_item(&state_item.into_ptr().as_mut_raw_ptr());
+
                                 parent.append_row_q_list_of_q_standard_item(qlist.as_ref());
+                            }
 
-                                // This is our parent now.
-                                let index = parent.row_count() - 1;
-                                parent = parent.child_1a(index);
+                            // If it's a folder, we check first if it's already in the TreeView using the following
+                            // logic:
+                            // - If the current parent has a child, it should be a folder already in the TreeView,
+                            //   so we check all his children.
+                            // - If any of them is equal to the current folder we are trying to add and it has at
+                            //   least one child, it's a folder exactly like the one we are trying to add, so that
+                            //   one becomes our new parent.
+                            // - If there is no equal folder to the one we are trying to add, we add it, turn it
+                            //   into the new parent, and repeat.
+                            else {
+
+                                // If the current parent has at least one child, check if the folder already exists.
+                                let mut duplicate_found = false;
+                                if parent.has_children() {
+
+                                    // It's a folder, so we check his children. We are only interested in
+                                    // folders, so ignore the files. Reverse because due to the sorting it's almost
+                                    // sure the last folder is the one we want.
+                                    for index in (0..parent.row_count()).rev() {
+                                        let child = parent.child_2a(index, 0);
+                                        if child.data_1a(ITEM_TYPE).to_int_0a() == ITEM_TYPE_FILE { continue }
+
+                                        // Get his text. If it's the same folder we are trying to add, this is our parent now.
+                                        if child.text().compare_q_string(&name) == 0 {
+                                            parent = parent.child_1a(index);
+                                            duplicate_found = true;
+                                            break;
+                                        }
+                                    }
+                                }
+
+                                // If our current parent doesn't have anything, just add it as a new folder.
+                                if !duplicate_found {
+                                    let folder = QStandardItem::from_q_string(&name);
+                                    let state_item = QStandardItem::new();
+                                    folder.set_editable(false);
+                                    set_item_type(&folder, ITEM_TYPE_FOLDER);
+                                    state_item.set_data_2a(&QVariant::from_int(ITEM_STATUS_PRISTINE), ITEM_STATUS);
+                                    state_item.set_editable(false);
+                                    state_item.set_flags(QFlags::from(flags));
+                                    let icon_type = IconType::Folder;
+                                    icon_type.set_icon_to_item_safe(&folder);
+
+                                    let qlist = QListOfQStandardItem::new();
+                                    qlist.append_q_standard_item(&folder.into_ptr().as_mut_raw_ptr());
+                                    qlist.append_q_standard_item(&state_item.into_ptr().as_mut_raw_ptr());
+                                    parent.append_row_q_list_of_q_standard_item(qlist.as_ref());
+
+                                    // This is our parent now.
+                                    let index = parent.row_count() - 1;
+                                    parent = parent.child_1a(index);
+                                }
                             }
                         }
                     }
@@ -1012,6 +1026,7 @@ impl PackTree for QBox<QTreeView> {
 
                     // We only use this to add files and empty folders. Ignore the rest.
                     if let TreePathType::File(ref path) | TreePathType::Folder(ref path) = &item_type {
+                        packed_file_model_fetch_path_safe(&model, path);
                         let mut parent = model.item_1a(0);
                         let mut parent_status = get_status_item_from_item(parent);
                         let flags = ItemFlag::from(parent_status.flags().to_int() & ItemFlag::ItemIsSelectable.to_int());
@@ -1075,7 +1090,7 @@ impl PackTree for QBox<QTreeView> {
                                     item_status.set_editable(false);
 
                                     if let TreePathType::File(ref path) = &item_type {
-                                        item.set_data_2a(&QVariant::from_int(ITEM_TYPE_FILE), ITEM_TYPE);
+                                        set_item_type(&item, ITEM_TYPE_FILE);
                                         IconType::set_icon_to_item_safe(&IconType::File(path.to_vec()), &item);
                                         if let Some(info) = packed_file_info {
                                             let tooltip = new_packed_file_tooltip(info);
@@ -1084,7 +1099,7 @@ impl PackTree for QBox<QTreeView> {
                                     }
 
                                     else if let TreePathType::Folder(_) = &item_type {
-                                        item.set_data_2a(&QVariant::from_int(ITEM_TYPE_FOLDER), ITEM_TYPE);
+                                        set_item_type(&item, ITEM_TYPE_FOLDER);
                                         IconType::set_icon_to_item_safe(&IconType::Folder, &item);
                                     }
 
@@ -1147,7 +1162,7 @@ impl PackTree for QBox<QTreeView> {
                                     let folder = QStandardItem::from_q_string(&QString::from_std_str(name)).into_ptr();
                                     let folder_status = QStandardItem::new().into_ptr();
                                     folder.set_editable(false);
-                                    folder.set_data_2a(&QVariant::from_int(ITEM_TYPE_FOLDER), ITEM_TYPE);
+                                    set_item_type(&folder, ITEM_TYPE_FOLDER);
 
                                     IconType::set_icon_to_item_safe(&IconType::Folder, &folder);
 
@@ -1194,6 +1209,7 @@ impl PackTree for QBox<QTreeView> {
                         TreePathType::File(path) => {
 
                             // Get the PackFile's item and the one we're gonna swap around, and the info to see how deep must we go.
+                            packed_file_model_fetch_path_safe(&model, &path);
                             let packfile = model.item_1a(0);
                             let mut item = model.item_1a(0);
                             let mut index = 0;
@@ -1275,6 +1291,7 @@ impl PackTree for QBox<QTreeView> {
                         TreePathType::Folder(path) => {
 
                             // Get the PackFile's item and the one we're gonna swap around, and the info to see how deep must we go.
+                            packed_file_model_fetch_path_safe(&model, &path);
                             let packfile = model.item_1a(0);
                             let mut item = model.item_1a(0);
                             let mut index = 0;
@@ -1572,6 +1589,54 @@ fn new_packed_file_tooltip(info: &PackedFileInfo) -> String {
     )
 }
 
+/// This function loads the provided sorted PackedFiles lazily under the big parent of a TreeView, if its model supports it.
+///
+/// The items are only created by the model once they're needed. If the model doesn't support it, this returns false and does nothing.
+unsafe fn load_lazy_tree(model: &QPtr<QStandardItemModel>, big_parent: Ptr<QStandardItem>, sorted_path_list: &[PackedFileInfo]) -> bool {
+
+    // Tooltips are the expensive part, so we pack the path and tooltip of each PackedFile in parallel.
+    let packed_entries = sorted_path_list.par_iter().map(|packed_file| {
+        let path = packed_file.path.join("/");
+        let tooltip = new_packed_file_tooltip(packed_file);
+
+        let mut entry = Vec::with_capacity(8 + path.len() + tooltip.len());
+        entry.extend_from_slice(&(path.len() as u32).to_ne_bytes());
+        entry.extend_from_slice(path.as_bytes());
+        entry.extend_from_slice(&(tooltip.len() as u32).to_ne_bytes());
+        entry.extend_from_slice(tooltip.as_bytes());
+        entry
+    }).collect::<Vec<Vec<u8>>>();
+
+    // Icons are shared by a lot of files, so we only send each one once, and refer to them by id. The id 0 is for folders.
+    packed_file_model_register_icon_safe(model, 0, IconType::Folder.get_icon_from_path());
+    let mut icons: Vec<*const QIcon> = vec![];
+    let mut buffer = Vec::with_capacity(packed_entries.iter().map(|x| x.len() + 1).sum());
+    for (packed_file, entry) in sorted_path_list.iter().zip(packed_entries.iter()) {
+        let icon = IconType::File(packed_file.path.to_vec()).get_icon_from_path();
+        let icon_id = match icons.iter().position(|x| *x == icon.as_raw_ptr()) {
+            Some(position) => position + 1,
+            None => {
+                icons.push(icon.as_raw_ptr());
+                packed_file_model_register_icon_safe(model, icons.len() as i32, icon);
+                icons.len()
+            }
+        };
+
+        buffer.extend_from_slice(entry);
+        buffer.push(icon_id as u8);
+    }
+
+    packed_file_model_load_lazy_safe(model, big_parent, &buffer, sorted_path_list.len() as i32)
+}
+
+/// This function sets the type of an item of the TreeView, along with the drag and drop flags of that type:
+/// everything but the PackFile can be dragged, and everything but files can be dropped into.
+unsafe fn set_item_type(item: &QStandardItem, item_type: i32) {
+    item.set_data_2a(&QVariant::from_int(item_type), ITEM_TYPE);
+    item.set_drag_enabled(item_type != ITEM_TYPE_PACKFILE);
+    item.set_drop_enabled(item_type != ITEM_TYPE_FILE);
+}
+
 /// This function cleans the entire TreeView from colors. To be used when saving.
 unsafe fn clean_treeview(item: Option<Ptr<QStandardItem>>, model: &QStandardItemModel) {
 
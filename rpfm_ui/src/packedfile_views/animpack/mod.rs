@@ -24,10 +24,8 @@ use qt_widgets::QPushButton;
 
 use qt_gui::QStandardItemModel;
 
-use qt_core::CaseSensitivity;
 use qt_core::QBox;
 use qt_core::QPtr;
-use qt_core::QRegExp;
 use qt_core::QSortFilterProxyModel;
 
 use std::rc::Rc;
@@ -246,15 +244,13 @@ impl PackedFileAnimPackView {
         let filter_autoexpand_matches_button = if is_anim_pack { &ui.anim_pack_filter_autoexpand_matches_button } else { &ui.pack_filter_autoexpand_matches_button };
 
         // Set the pattern to search.
-        let pattern = QRegExp::new_1a(&filter_line_edit.text());
+        let pattern = filter_line_edit.text();
 
         // Check if the filter should be "Case Sensitive".
         let case_sensitive = filter_case_sensitive_button.is_checked();
-        if case_sensitive { pattern.set_case_sensitivity(CaseSensitivity::CaseSensitive); }
-        else { pattern.set_case_sensitivity(CaseSensitivity::CaseInsensitive); }
 
         // Filter whatever it's in that column by the text we got.
-        trigger_treeview_filter_safe(&tree_model_filter, &pattern.as_ptr());
+        trigger_treeview_filter_safe(&tree_model_filter, &pattern.as_ptr(), case_sensitive);
 
         // Expand all the matches, if the option for it is enabled.
         if filter_autoexpand_matches_button.is_checked() {
@@ -32,7 +32,6 @@ use rpfm_lib::packedfile::text::Text;
 use crate::app_ui::AppUI;
 use crate::CENTRAL_COMMAND;
 use crate::communications::{Command, Response, THREADS_COMMUNICATION_ERROR};
-use crate::ffi::get_text_safe;
 use crate::pack_tree::*;
 use crate::packfile_contents_ui::PackFileContentsUI;
 use crate::views::table::utils::get_table_from_view;
@@ -328,8 +327,7 @@ impl PackedFileView {
                             PackedFileType::Text(_) => {
                                 if let View::Text(view) = view {
                                     let mut text = Text::default();
-                                    let widget = view.get_mut_editor();
-                                    let string = get_text_safe(&widget).to_std_string();
+                                    let string = view.get_text();
                                     text.set_contents(&string);
                                     DecodedPackedFile::Text(text)
                                 } else { return Err(ErrorKind::PackedFileSaveError(self.get_path()).into()) }
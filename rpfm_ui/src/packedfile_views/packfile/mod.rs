@@ -26,8 +26,6 @@ use qt_gui::QStandardItemModel;
 
 use qt_core::QBox;
 use qt_core::QPtr;
-use qt_core::CaseSensitivity;
-use qt_core::QRegExp;
 use qt_core::QSortFilterProxyModel;
 
 use std::path::PathBuf;
@@ -191,15 +189,13 @@ impl PackFileExtraView {
     pub unsafe fn filter_files(view: &Arc<Self>) {
 
         // Set the pattern to search.
-        let pattern = QRegExp::new_1a(&view.filter_line_edit.text());
+        let pattern = view.filter_line_edit.text();
 
         // Check if the filter should be "Case Sensitive".
         let case_sensitive = view.filter_case_sensitive_button.is_checked();
-        if case_sensitive { pattern.set_case_sensitivity(CaseSensitivity::CaseSensitive); }
-        else { pattern.set_case_sensitivity(CaseSensitivity::CaseInsensitive); }
 
         // Filter whatever it's in that column by the text we got.
-        trigger_treeview_filter_safe(&view.tree_model_filter, &pattern.as_ptr());
+        trigger_treeview_filter_safe(&view.tree_model_filter, &pattern.as_ptr(), case_sensitive);
 
         // Expand all the matches, if the option for it is enabled.
         if view.filter_autoexpand_matches_button.is_checked() {
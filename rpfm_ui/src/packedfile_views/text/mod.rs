@@ -30,7 +30,7 @@ use crate::app_ui::AppUI;
 use crate::CENTRAL_COMMAND;
 use crate::diagnostics_ui::DiagnosticsUI;
 use crate::communications::*;
-use crate::ffi::{new_text_editor_safe, set_text_safe};
+use crate::ffi::{new_text_editor_safe, set_text_utf8_safe, get_modified_text_safe, reset_modified_text_safe};
 use crate::global_search_ui::GlobalSearchUI;
 use crate::packfile_contents_ui::PackFileContentsUI;
 use crate::packedfile_views::{PackedFileView, View, ViewType};
@@ -51,6 +51,9 @@ const JSON: &str = "JSON";
 /// This struct contains the view of a Text PackedFile.
 pub struct PackedFileTextView {
     editor: QBox<QWidget>,
+
+    /// Text as of the last time it was loaded or read back from the editor, so we only need to read back the lines that changed.
+    contents: RwLock<String>,
     _path: Arc<RwLock<Vec<String>>>,
 }
 
@@ -97,9 +100,13 @@ impl PackedFileTextView {
         let layout: QPtr<QGridLayout> = packed_file_view.get_mut_widget().layout().static_downcast();
         layout.add_widget_5a(&editor, 0, 0, 1, 1);
 
-        set_text_safe(&editor, &QString::from_std_str(text.get_ref_contents()).as_ptr(), &highlighting_mode.as_ptr());
+        set_text_utf8_safe(&editor, text.get_ref_contents(), &highlighting_mode.as_ptr());
 
-        let packed_file_text_view = Arc::new(PackedFileTextView {editor, _path: packed_file_view.get_path_raw() });
+        let packed_file_text_view = Arc::new(PackedFileTextView {
+            editor,
+            contents: RwLock::new(text.get_ref_contents().to_owned()),
+            _path: packed_file_view.get_path_raw()
+        });
         //let packed_file_text_view_slots = PackedFileTextViewSlots::new(&packed_file_text_view, app_ui, pack_file_contents_ui, global_search_ui, diagnostics_ui);
 
         packed_file_view.packed_file_type = PackedFileType::Text(text.get_text_type());
@@ -127,6 +134,42 @@ impl PackedFileTextView {
             TextType::Json => QString::from_std_str(JSON),
         };
 
-        set_text_safe(&self.editor, &QString::from_std_str(data.get_ref_contents()).as_ptr(), &highlighting_mode.as_ptr());
+        set_text_utf8_safe(&self.editor, data.get_ref_contents(), &highlighting_mode.as_ptr());
+        *self.contents.write().unwrap() = data.get_ref_contents().to_owned();
+    }
+
+    /// This function returns the current text of the view.
+    ///
+    /// Only the lines changed since the last call are read back from the editor. The rest are reused from the text we already had.
+    pub unsafe fn get_text(&self) -> String {
+        let mut contents = self.contents.write().unwrap();
+        if let Some((first_line, original_last_line, text)) = get_modified_text_safe(&self.editor) {
+            let start = get_line_start(&contents, first_line);
+            let mut end = get_line_end(&contents, original_last_line).max(start);
+
+            // The editor joins the lines with \n, so keep the line endings of the text if they're different.
+            let text = if contents.contains("\r\n") {
+                if contents[..end].ends_with('\r') && end > start { end -= 1; }
+                text.replace('\n', "\r\n")
+            } else { text };
+
+            contents.replace_range(start..end, &text);
+            reset_modified_text_safe(&self.editor);
+        }
+
+        contents.clone()
+    }
+}
+
+/// This function returns the byte position where the provided line (0-based) of a text starts.
+fn get_line_start(text: &str, line: usize) -> usize {
+    if line == 0 { 0 }
+    else {
+        text.match_indices('\n').nth(line - 1).map(|(index, _)| index + 1).unwrap_or_else(|| text.len())
     }
 }
+
+/// This function returns the byte position where the provided line (0-based) of a text ends, before its line break.
+fn get_line_end(text: &str, line: usize) -> usize {
+    text.match_indices('\n').nth(line).map(|(index, _)| index).unwrap_or_else(|| text.len())
+}
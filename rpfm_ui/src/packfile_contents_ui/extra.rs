@@ -25,9 +25,7 @@ use qt_widgets::QLabel;
 use qt_widgets::QLineEdit;
 use qt_widgets::QPushButton;
 
-use qt_core::CaseSensitivity;
 use qt_core::QBox;
-use qt_core::QRegExp;
 use qt_core::QString;
 use qt_core::SlotNoArgs;
 
@@ -154,15 +152,13 @@ impl PackFileContentsUI {
     pub unsafe fn filter_files(pack_file_contents_ui: &Rc<Self>) {
 
         // Set the pattern to search.
-        let pattern = QRegExp::new_1a(&pack_file_contents_ui.filter_line_edit.text());
+        let pattern = pack_file_contents_ui.filter_line_edit.text();
 
         // Check if the filter should be "Case Sensitive".
         let case_sensitive = pack_file_contents_ui.filter_case_sensitive_button.is_checked();
-        if case_sensitive { pattern.set_case_sensitivity(CaseSensitivity::CaseSensitive); }
-        else { pattern.set_case_sensitivity(CaseSensitivity::CaseInsensitive); }
 
         // Filter whatever it's in that column by the text we got.
-        trigger_treeview_filter_safe(&pack_file_contents_ui.packfile_contents_tree_model_filter, &pattern.as_ptr());
+        trigger_treeview_filter_safe(&pack_file_contents_ui.packfile_contents_tree_model_filter, &pattern.as_ptr(), case_sensitive);
 
         // Expand all the matches, if the option for it is enabled.
         if pack_file_contents_ui.filter_autoexpand_matches_button.is_checked() {
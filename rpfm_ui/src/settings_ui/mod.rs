@@ -49,6 +49,7 @@ use rpfm_lib::settings::{Settings, MYMOD_BASE_PATH, ZIP_PATH};
 use rpfm_lib::updater::{BETA, STABLE, get_update_channel, UpdateChannel};
 
 use crate::AppUI;
+use crate::ffi::invalidate_theme_palette_safe;
 use crate::{Locale, locale::{qtr, qtre}};
 use crate::QT_PROGRAM;
 use crate::QT_ORG;
@@ -983,6 +984,9 @@ impl SettingsUI {
 
         q_settings.sync();
 
+        // The delegates keep the colours loaded, so make them reload the new ones.
+        invalidate_theme_palette_safe();
+
         // Get the Debug Settings.
         settings.settings_bool.insert("check_for_missing_table_definitions".to_owned(), self.debug_check_for_missing_table_definitions_checkbox.is_checked());
         settings.settings_bool.insert("enable_debug_menu".to_owned(), self.debug_enable_debug_menu_checkbox.is_checked());
@@ -51,7 +51,7 @@ use rpfm_lib::{GAME_SELECTED, packedfile::PackedFileType};
 use crate::ASSETS_PATH;
 use crate::CENTRAL_COMMAND;
 use crate::communications::{Command, Response, THREADS_COMMUNICATION_ERROR};
-use crate::ffi::{new_text_editor_safe, set_text_safe};
+use crate::ffi::{new_text_editor_safe, set_text_editor_large_file_read_only_safe, set_text_utf8_safe};
 use crate::locale::{qtr, qtre};
 use crate::ORANGE;
 use crate::SLIGHTLY_DARKER_GREY;
@@ -134,7 +134,10 @@ pub unsafe fn show_debug_dialog<T: AsRef<str>>(parent: impl cpp_core::CastInto<P
     let editor = new_text_editor_safe(&widget.static_upcast());
 
     layout.add_widget_5a(&editor, 0, 0, 1, 1);
-    set_text_safe(&editor, &QString::from_std_str(text).as_ptr(), &QString::from_std_str("plain").as_ptr());
+
+    // This is just for reading, so big dumps don't need to be editable or highlighted.
+    set_text_editor_large_file_read_only_safe(&editor, true);
+    set_text_utf8_safe(&editor, text.as_ref(), &QString::from_std_str("plain").as_ptr());
 
     // Center it on screen.
     window.resize_2a(1000, 600);
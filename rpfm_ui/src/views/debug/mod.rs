@@ -26,7 +26,7 @@ use rpfm_error::Result;
 use rpfm_lib::packedfile::DecodedPackedFile;
 use rpfm_lib::packedfile::PackedFileType;
 
-use crate::ffi::{new_text_editor_safe, set_text_safe, get_text_safe};
+use crate::ffi::{new_text_editor_safe, set_text_utf8_safe, get_text_utf8_safe};
 use crate::locale::qtr;
 use crate::views::debug::slots::DebugViewSlots;
 
@@ -75,7 +75,7 @@ impl DebugView {
             _ => unimplemented!(),
         };
 
-        set_text_safe(&editor, &QString::from_std_str(text).as_ptr(), &QString::from_std_str(JSON).as_ptr());
+        set_text_utf8_safe(&editor, &text, &QString::from_std_str(JSON).as_ptr());
 
         let packed_file_debug_view = Arc::new(Self {
             editor,
@@ -92,7 +92,7 @@ impl DebugView {
 
     /// This function tries to parse the passed file as a PackedFile and returns it.
     pub fn save_view(&self) -> Result<DecodedPackedFile> {
-        let string = get_text_safe(&self.editor).to_std_string();
+        let string = get_text_utf8_safe(&self.editor);
 
         let decoded_packed_file = match self.packed_file_type {
             PackedFileType::UnitVariant => DecodedPackedFile::UnitVariant(serde_json::from_str(&string)?),
@@ -105,7 +105,7 @@ impl DebugView {
     /// Function to reload the data of the view without having to delete the view itself.
     pub unsafe fn reload_view(&self, data: &str) {
         let highlighting_mode = QString::from_std_str(JSON);
-        set_text_safe(&self.editor, &QString::from_std_str(data).as_ptr(), &highlighting_mode.as_ptr());
+        set_text_utf8_safe(&self.editor, data, &highlighting_mode.as_ptr());
     }
 
     /// This function returns a copy of the path of this `DebugView`.
@@ -90,18 +90,23 @@ pub static COLUMN_SIZE_BOOLEAN: i32 = 100;
 pub static COLUMN_SIZE_NUMBER: i32 = 140;
 pub static COLUMN_SIZE_STRING: i32 = 350;
 
+// Tables with at least this amount of rows get a trigram index to speed up their filters.
+pub static TRIGRAM_INDEX_MIN_ROWS: i32 = 25_000;
 
 pub static ITEM_IS_KEY: i32 = 20;
 pub static ITEM_IS_ADDED: i32 = 21;
 pub static ITEM_IS_MODIFIED: i32 = 22;
-pub static ITEM_HAS_ERROR: i32 = 25;
-pub static ITEM_HAS_WARNING: i32 = 26;
-pub static ITEM_HAS_INFO: i32 = 27;
 pub static ITEM_HAS_SOURCE_VALUE: i32 = 30;
 pub static ITEM_SOURCE_VALUE: i32 = 31;
 pub static ITEM_IS_SEQUENCE: i32 = 35;
 pub static ITEM_SEQUENCE_DATA: i32 = 36;
 
+// Packed status of a cell, as the delegates paint it. Each bit mirrors one of the status roles above, and `set_item_status` keeps them in sync.
+pub static ITEM_STATUS: i32 = 40;
+pub static ITEM_STATUS_KEY: u32 = 1;
+pub static ITEM_STATUS_ADDED: u32 = 2;
+pub static ITEM_STATUS_MODIFIED: u32 = 4;
+
 //-------------------------------------------------------------------------------//
 //                              Enums & Structs
 //-------------------------------------------------------------------------------//
@@ -321,6 +326,9 @@ impl TableView {
             table_view_frozen.vertical_header().set_default_section_size(22);
         }
 
+        // Our cells are single-line, so all rows can have the same height.
+        set_uniform_row_height_safe(&table_view_primary.as_ptr(), 0);
+
         let warning_message = QLabel::from_q_string_q_widget(&qtr("dependency_packfile_list_label"), parent);
 
         // Create the filter's widgets.
@@ -617,7 +625,6 @@ impl TableView {
         // the columns, the titles will be reseted to 1, 2, 3,... so we do this here.
         load_data(
             &packed_file_table_view.get_mut_ptr_table_view_primary(),
-            &packed_file_table_view.get_mut_ptr_table_view_frozen(),
             &packed_file_table_view.table_definition.read().unwrap(),
             &packed_file_table_view.dependency_data,
             &table_data,
@@ -635,7 +642,6 @@ impl TableView {
 
         build_columns(
             &packed_file_table_view.get_mut_ptr_table_view_primary(),
-            Some(&packed_file_table_view.get_mut_ptr_table_view_frozen()),
             &packed_file_table_view.table_definition.read().unwrap(),
             table_name.as_ref()
         );
@@ -653,7 +659,6 @@ impl TableView {
     /// NOTE: This allows for a table to change it's definition on-the-fly, so be carefull with that!
     pub unsafe fn reload_view(&self, data: TableType) {
         let table_view_primary = &self.get_mut_ptr_table_view_primary();
-        let table_view_frozen = &self.get_mut_ptr_table_view_frozen();
         let undo_model = &self.get_mut_ptr_undo_model();
 
         let filter: QPtr<QSortFilterProxyModel> = table_view_primary.model().static_downcast();
@@ -676,7 +681,6 @@ impl TableView {
         // the columns, the titles will be reseted to 1, 2, 3,... so we do this here.
         load_data(
             &table_view_primary,
-            &table_view_frozen,
             &self.get_ref_table_definition(),
             &self.dependency_data,
             &data,
@@ -699,7 +703,6 @@ impl TableView {
         // Rebuild the column's stuff.
         build_columns(
             &table_view_primary,
-            Some(&table_view_frozen),
             &self.get_ref_table_definition(),
             table_name.as_ref()
         );
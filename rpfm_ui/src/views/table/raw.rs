@@ -200,7 +200,8 @@ impl TableView {
             }
         }
 
-        // Filter whatever it's in that column by the text we got.
+        // Filter whatever it's in that column by the text we got. Big tables get their filters indexed.
+        set_tableview_filter_trigram_index_safe(&self.table_filter, self.table_model.row_count_0a() >= TRIGRAM_INDEX_MIN_ROWS);
         trigger_tableview_filter_safe(&self.table_filter, &columns, patterns, &sensitivity, &show_blank_cells, &match_groups);
     }
 
@@ -608,7 +609,7 @@ impl TableView {
                         if real_row == -1 {
                             let row = get_new_row(&self.get_ref_table_definition());
                             for index in 0..row.count_0a() {
-                                row.value_1a(index).set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
+                                set_item_status(row.value_1a(index), ITEM_IS_ADDED, true);
                             }
                             self.table_model.append_row_q_list_of_q_standard_item(&row);
                             real_row = self.table_model.row_count_0a() - 1;
@@ -960,8 +961,8 @@ impl TableView {
                 for column in 0..columns {
                     let original_item = self.table_model.item_2a(index.row(), column);
                     let item = (*original_item).clone();
-                    item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
-                    item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_MODIFIED);
+                    set_item_status(item, ITEM_IS_ADDED, true);
+                    set_item_status(item, ITEM_IS_MODIFIED, false);
                     qlist.append_q_standard_item(&item.as_mut_raw_ptr());
                 }
 
@@ -971,7 +972,7 @@ impl TableView {
         } else {
             let row = get_new_row(&self.get_ref_table_definition());
             for index in 0..row.count_0a() {
-                row.value_1a(index).set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
+                set_item_status(row.value_1a(index), ITEM_IS_ADDED, true);
             }
             vec![row]
         };
@@ -1023,7 +1024,7 @@ impl TableView {
         if indexes_sorted.is_empty() {
             let row = get_new_row(&self.get_ref_table_definition());
             for index in 0..row.count_0a() {
-                row.value_1a(index).set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
+                set_item_status(row.value_1a(index), ITEM_IS_ADDED, true);
             }
             self.table_model.append_row_q_list_of_q_standard_item(&row);
             row_numbers.push(self.table_model.row_count_0a() - 1);
@@ -1042,15 +1043,15 @@ impl TableView {
                 for column in 0..columns {
                     let original_item = self.table_model.item_2a(index.row(), column);
                     let item = (*original_item).clone();
-                    item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
-                    item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_MODIFIED);
+                    set_item_status(item, ITEM_IS_ADDED, true);
+                    set_item_status(item, ITEM_IS_MODIFIED, false);
                     qlist.append_q_standard_item(&item.as_mut_raw_ptr());
                 }
                 qlist
             } else {
                 let row = get_new_row(&self.get_ref_table_definition());
                 for index in 0..row.count_0a() {
-                    row.value_1a(index).set_data_2a(&QVariant::from_bool(true), ITEM_IS_ADDED);
+                    set_item_status(row.value_1a(index), ITEM_IS_ADDED, true);
                 }
                 row
             };
@@ -1426,7 +1427,7 @@ impl TableView {
             let operation = TableOperations::Editing(edition);
             self.history_undo.write().unwrap().push(operation);
 
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_MODIFIED);
+            set_item_status(item, ITEM_IS_MODIFIED, true);
         }
     }
 
@@ -1799,11 +1800,11 @@ impl TableView {
                 let item = table_model.item_2a(row, column);
 
                 if item.data_1a(ITEM_IS_ADDED).to_bool() == true {
-                    item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_ADDED);
+                    set_item_status(item, ITEM_IS_ADDED, false);
                 }
 
                 if item.data_1a(ITEM_IS_MODIFIED).to_bool() == true {
-                    item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_MODIFIED);
+                    set_item_status(item, ITEM_IS_MODIFIED, false);
                 }
             }
         }
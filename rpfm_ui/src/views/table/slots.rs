@@ -206,7 +206,7 @@ impl TableViewSlots {
                         {
                             // We block the saving for painting, so this doesn't get rettriggered again.
                             let blocker = QSignalBlocker::from_q_object(&view.table_model);
-                            item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_MODIFIED);
+                            set_item_status(item, ITEM_IS_MODIFIED, true);
                             blocker.unblock();
                         }
 
@@ -421,7 +421,6 @@ impl TableViewSlots {
                                 view.undo_lock.store(true, Ordering::SeqCst);
                                 load_data(
                                     &view.get_mut_ptr_table_view_primary(),
-                                    &view.get_mut_ptr_table_view_frozen(),
                                     &view.get_ref_table_definition(),
                                     &view.dependency_data,
                                     &data,
@@ -439,7 +438,6 @@ impl TableViewSlots {
 
                                 build_columns(
                                     &view.get_mut_ptr_table_view_primary(),
-                                    Some(&view.get_mut_ptr_table_view_frozen()),
                                     &view.get_ref_table_definition(),
                                     table_name.as_ref()
                                 );
@@ -21,7 +21,6 @@ use qt_gui::QStandardItem;
 use qt_gui::QStandardItemModel;
 
 use qt_core::QModelIndex;
-use qt_core::QSignalBlocker;
 use qt_core::QSortFilterProxyModel;
 use qt_core::QVariant;
 use qt_core::QObject;
@@ -37,6 +36,8 @@ use cpp_core::Ref;
 use rayon::prelude::*;
 
 use std::collections::BTreeMap;
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
 use std::cmp::{Ordering, Reverse};
 use std::rc::Rc;
 use std::sync::{atomic::AtomicPtr, RwLock};
@@ -318,12 +319,28 @@ pub unsafe fn get_default_item_from_field(field: &Field) -> CppBox<QStandardItem
     };
 
     if field.get_is_key() {
-        item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_KEY);
+        set_item_status(item.as_ptr(), ITEM_IS_KEY, true);
     }
 
     item
 }
 
+/// This function sets one of the status roles (key, added or modified) of a cell, updating its packed status along with it.
+pub unsafe fn set_item_status(item: Ptr<QStandardItem>, role: i32, value: bool) {
+    let bit = if role == ITEM_IS_KEY { ITEM_STATUS_KEY }
+        else if role == ITEM_IS_ADDED { ITEM_STATUS_ADDED }
+        else if role == ITEM_IS_MODIFIED { ITEM_STATUS_MODIFIED }
+        else { 0 };
+
+    item.set_data_2a(&QVariant::from_bool(value), role);
+
+    let status = item.data_1a(ITEM_STATUS).to_u_int_0a();
+    let new_status = if value { status | bit } else { status & !bit };
+    if new_status != status {
+        item.set_data_2a(&QVariant::from_uint(new_status), ITEM_STATUS);
+    }
+}
+
 /// This function "process" the column names of a table, so they look like they should.
 pub fn clean_column_names(field_name: &str) -> String {
     let mut new_name = String::new();
@@ -350,7 +367,6 @@ pub fn clean_column_names(field_name: &str) -> String {
 /// This function loads the data from a compatible `PackedFile` into a TableView.
 pub unsafe fn load_data(
     table_view_primary: &QPtr<QTableView>,
-    table_view_frozen: &QPtr<QTableView>,
     definition: &Definition,
     dependency_data: &RwLock<BTreeMap<i32, DependencyData>>,
     data: &TableType,
@@ -377,25 +393,10 @@ pub unsafe fn load_data(
 
     if !data.is_empty() {
 
-        // Load the data, row by row.
-        let blocker = QSignalBlocker::from_q_object(table_model.static_upcast::<QObject>());
+        // Load the data, all at once. The items are built on the C++ side from a packed copy of the table.
         let keys = definition.get_fields_processed().iter().enumerate().filter_map(|(x, y)| if y.get_is_key() { Some(x as i32) } else { None }).collect::<Vec<i32>>();
-        for (row, entry) in data.iter().enumerate() {
-            let qlist = QListOfQStandardItem::new();
-            for (column, field) in entry.iter().enumerate() {
-                let item = get_item_from_decoded_data(field, &keys, column);
-
-                if data_source != DataSource::PackFile {
-                    item.set_editable(false);
-                }
-
-                qlist.append_q_standard_item(&item.into_ptr().as_mut_raw_ptr());
-            }
-            if row == data.len() - 1 {
-                blocker.unblock();
-            }
-            table_model.append_row_q_list_of_q_standard_item(&qlist);
-        }
+        let (buffer, column_types) = get_packed_table_data(data);
+        load_table_data_safe(&table_model, &buffer, data.len() as i32, &column_types, &keys, data_source == DataSource::PackFile);
     }
 
     // If the table it's empty, we add an empty row and delete it, so the "columns" get created.
@@ -407,114 +408,79 @@ pub unsafe fn load_data(
 
     setup_item_delegates(
         table_view_primary,
-        &table_view_frozen,
         definition,
         &dependency_data.read().unwrap(),
         timer
     )
 }
 
-/// This function generates a StandardItem for the provided DecodedData.
-pub unsafe fn get_item_from_decoded_data(data: &DecodedData, keys: &[i32], column: usize) -> CppBox<QStandardItem> {
-    let item = match *data {
-
-        // This one needs a couple of changes before turning it into an item in the table.
-        DecodedData::Boolean(ref data) => {
-            let item = QStandardItem::new();
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_bool(*data), ITEM_SOURCE_VALUE);
-            item.set_tool_tip(&QString::from_std_str(&tre("original_data", &[&data.to_string()])));
-            item.set_editable(false);
-            item.set_checkable(true);
-            item.set_check_state(if *data { CheckState::Checked } else { CheckState::Unchecked });
-            item
-        }
+/// This function packs the data of a table into a single buffer, in the format `load_table_data` expects on the C++ side,
+/// returning it along with the type of each column.
+///
+/// Rows are packed in parallel, as they don't depend on each other.
+pub fn get_packed_table_data(data: &[Vec<DecodedData>]) -> (Vec<u8>, Vec<i32>) {
+    let column_types = match data.first() {
+        Some(row) => row.iter().map(|field| match field {
+            DecodedData::Boolean(_) => 0,
+            DecodedData::I16(_) | DecodedData::I32(_) => 1,
+            DecodedData::I64(_) => 2,
+            DecodedData::F32(_) => 3,
+            DecodedData::StringU8(_) |
+            DecodedData::StringU16(_) |
+            DecodedData::OptionalStringU8(_) |
+            DecodedData::OptionalStringU16(_) => 4,
+            DecodedData::SequenceU16(_) | DecodedData::SequenceU32(_) => 5,
+        }).collect::<Vec<i32>>(),
+        None => vec![],
+    };
 
-        // Floats need to be tweaked to fix trailing zeroes and precission issues, like turning 0.5000004 into 0.5.
-        // Also, they should be limited to 3 decimals.
-        DecodedData::F32(ref data) => {
-            let data = {
-                let data_str = format!("{}", data);
-                if let Some(position) = data_str.find('.') {
-                    let decimals = &data_str[position..].len();
-                    if *decimals > 3 { format!("{:.3}", data).parse::<f32>().unwrap() }
-                    else { *data }
+    let buffer = data.par_iter().map(|row| {
+        let mut buffer = Vec::with_capacity(row.len() * 8);
+        for field in row {
+            match field {
+                DecodedData::Boolean(data) => buffer.push(*data as u8),
+                DecodedData::F32(data) => buffer.extend_from_slice(&clean_float(*data).to_ne_bytes()),
+                DecodedData::I16(data) => buffer.extend_from_slice(&(*data as i32).to_ne_bytes()),
+                DecodedData::I32(data) => buffer.extend_from_slice(&data.to_ne_bytes()),
+                DecodedData::I64(data) => buffer.extend_from_slice(&data.to_ne_bytes()),
+                DecodedData::StringU8(data) |
+                DecodedData::StringU16(data) |
+                DecodedData::OptionalStringU8(data) |
+                DecodedData::OptionalStringU16(data) => {
+                    buffer.extend_from_slice(&(data.len() as u32).to_ne_bytes());
+                    buffer.extend_from_slice(data.as_bytes());
                 }
-                else { *data }
-            };
-
-            let item = QStandardItem::new();
-            item.set_tool_tip(&QString::from_std_str(&tre("original_data", &[&data.to_string()])));
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_float(data), ITEM_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_float(data), 2);
-            item
-        },
-        DecodedData::I16(ref data) => {
-            let item = QStandardItem::new();
-            item.set_tool_tip(&QString::from_std_str(tre("original_data", &[&data.to_string()])));
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_int(*data as i32), ITEM_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_int(*data as i32), 2);
-            item
-        },
-        DecodedData::I32(ref data) => {
-            let item = QStandardItem::new();
-            item.set_tool_tip(&QString::from_std_str(tre("original_data", &[&data.to_string()])));
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_int(*data), ITEM_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_int(*data), 2);
-            item
-        },
-        DecodedData::I64(ref data) => {
-            let item = QStandardItem::new();
-            item.set_tool_tip(&QString::from_std_str(&tre("original_data", &[&data.to_string()])));
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_i64(*data), ITEM_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_i64(*data), 2);
-            item
-        },
-        // All these are Strings, so it can be together,
-        DecodedData::StringU8(ref data) |
-        DecodedData::StringU16(ref data) |
-        DecodedData::OptionalStringU8(ref data) |
-        DecodedData::OptionalStringU16(ref data) => {
-            let item = QStandardItem::from_q_string(&QString::from_std_str(data));
-            item.set_tool_tip(&QString::from_std_str(&tre("original_data", &[&data])));
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_q_string(&QString::from_std_str(data)), ITEM_SOURCE_VALUE);
-            item
-        },
-        DecodedData::SequenceU16(ref table) | DecodedData::SequenceU32(ref table) => {
-            let table = QString::from_std_str(&serde_json::to_string(&table).unwrap());
-            let item = QStandardItem::from_q_string(&qtr("packedfile_editable_sequence"));
-            item.set_editable(false);
-            item.set_data_2a(&QVariant::from_bool(false), ITEM_HAS_SOURCE_VALUE);
-            item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_SEQUENCE);
-            item.set_data_2a(&QVariant::from_q_string(&table), ITEM_SEQUENCE_DATA);
-            item
+                DecodedData::SequenceU16(table) | DecodedData::SequenceU32(table) => {
+                    let table = serde_json::to_string(&table).unwrap();
+                    buffer.extend_from_slice(&(table.len() as u32).to_ne_bytes());
+                    buffer.extend_from_slice(table.as_bytes());
+                }
+            }
         }
-    };
+        buffer
+    }).collect::<Vec<Vec<u8>>>().concat();
 
-    if keys.contains(&(column as i32)) {
-        item.set_data_2a(&QVariant::from_bool(true), ITEM_IS_KEY);
+    (buffer, column_types)
+}
 
+/// This function fixes trailing zeroes and precission issues on floats, like turning 0.5000004 into 0.5.
+/// They're also limited to 3 decimals.
+pub fn clean_float(data: f32) -> f32 {
+    let data_str = format!("{}", data);
+    if let Some(position) = data_str.find('.') {
+        let decimals = &data_str[position..].len();
+        if *decimals > 3 { format!("{:.3}", data).parse::<f32>().unwrap() }
+        else { data }
     }
-
-    item
+    else { data }
 }
 
 /// This function is meant to be used to prepare and build the column headers, and the column-related stuff.
 /// His intended use is for just after we load/reload the data to the table.
+///
+/// The frozen view follows the column order of the primary one by itself, so only the primary one needs to be set up here.
 pub unsafe fn build_columns(
     table_view_primary: &QPtr<QTableView>,
-    table_view_frozen: Option<&QPtr<QTableView>>,
     definition: &Definition,
     table_name: Option<&String>,
 ) {
@@ -571,11 +537,6 @@ pub unsafe fn build_columns(
             if *ca_order != -1 {
                 let visual_index = header_primary.visual_index(*logical_index as i32);
                 header_primary.move_section(visual_index as i32, new_pos as i32);
-
-                if let Some(ref table_view_frozen) = table_view_frozen {
-                    let header_frozen = table_view_frozen.horizontal_header();
-                    header_frozen.move_section(visual_index as i32, new_pos as i32);
-                }
             }
         }
     }
@@ -585,11 +546,6 @@ pub unsafe fn build_columns(
         let header_primary = table_view_primary.horizontal_header();
         for (position, column) in keys.iter().enumerate() {
             header_primary.move_section(*column as i32, position as i32);
-
-            if let Some(ref table_view_frozen) = table_view_frozen {
-                let header_frozen = table_view_frozen.horizontal_header();
-                header_frozen.move_section(*column as i32, position as i32);
-            }
         }
     }
 
@@ -752,10 +708,29 @@ pub unsafe fn get_reference_data(table_name: &str, definition: &Definition) -> R
     }
 }
 
+/// This function returns the key of the shared list of values of a combo column.
+///
+/// Reference columns use the column they reference, so all the tables referencing it share the same list.
+/// Enum columns use their values, as they're not shared between tables.
+fn get_reference_list_key(field: &Field) -> String {
+    match field.get_is_reference() {
+        Some((ref_table, ref_column)) => format!("{}/{}/{}", ref_table, ref_column, field.get_enum_values_to_string()),
+        None => format!("enum/{}", field.get_enum_values_to_string()),
+    }
+}
+
+/// This function returns the version of a list of values of a combo column, which changes when any of the values changes.
+fn get_reference_list_version(values: &[&String]) -> u64 {
+    let mut hasher = DefaultHasher::new();
+    values.hash(&mut hasher);
+    hasher.finish()
+}
+
 /// This function sets up the item delegates for all columns in a table.
+///
+/// They're only created for the primary view. The frozen view reuses the same instances.
 pub unsafe fn setup_item_delegates(
     table_view_primary: &QPtr<QTableView>,
-    table_view_frozen: &QPtr<QTableView>,
     definition: &Definition,
     dependency_data: &BTreeMap<i32, DependencyData>,
     timer: &QBox<QTimer>
@@ -765,59 +740,62 @@ pub unsafe fn setup_item_delegates(
 
         // Combos are a bit special, as they may or may not replace other delegates. If we disable them, use the normal delegates.
         if !SETTINGS.read().unwrap().settings_bool["disable_combos_on_tables"] && dependency_data.get(&(column as i32)).is_some() || !field.get_enum_values().is_empty() {
-            let list = QStringList::new();
+            let mut values = vec![];
             if let Some(data) = dependency_data.get(&(column as i32)) {
-                let mut data = data.data.iter().map(|x| if enable_lookups { x.1 } else { x.0 }).collect::<Vec<&String>>();
-                data.sort();
-                data.iter().for_each(|x| list.append_q_string(&QString::from_std_str(x)));
+                values = data.data.iter().map(|x| if enable_lookups { x.1 } else { x.0 }).collect::<Vec<&String>>();
+                values.sort();
             }
 
             if !field.get_enum_values().is_empty() {
-                field.get_enum_values().values().for_each(|x| list.append_q_string(&QString::from_std_str(x)));
+                values.extend(field.get_enum_values().values());
+            }
+
+            // The list is shared with every other table referencing the same column, so we only build it if it's not already registered.
+            let key = QString::from_std_str(&get_reference_list_key(field));
+            let version = get_reference_list_version(&values);
+            let mut handle = reference_list_find_safe(&key.as_ptr(), version);
+            if handle == -1 {
+                let list = QStringList::new();
+                values.iter().for_each(|x| list.append_q_string(&QString::from_std_str(x)));
+                handle = reference_list_register_safe(&key.as_ptr(), version, &list.as_ptr());
             }
 
-            new_combobox_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, list.as_ptr(), true, field.get_max_length(), &timer.as_ptr(), true);
-            new_combobox_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, list.as_ptr(), true, field.get_max_length(), &timer.as_ptr(), true);
+            new_combobox_item_delegate_shared_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, handle, true, field.get_max_length(), &timer.as_ptr(), true);
         }
 
         else {
             match field.get_ref_field_type() {
                 FieldType::Boolean => {
                     new_generic_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
-                    new_generic_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
                 },
                 FieldType::F32 => {
                     new_doublespinbox_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
-                    new_doublespinbox_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
                 },
                 FieldType::I16 => {
                     new_spinbox_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, 16, &timer.as_ptr(), true);
-                    new_spinbox_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, 16, &timer.as_ptr(), true);
                 },
                 FieldType::I32 => {
                     new_spinbox_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, 32, &timer.as_ptr(), true);
-                    new_spinbox_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, 32, &timer.as_ptr(), true);
                 },
 
                 // LongInteger uses normal string controls due to QSpinBox being limited to i32.
                 FieldType::I64 => {
                     new_spinbox_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, 64, &timer.as_ptr(), true);
-                    new_spinbox_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, 64, &timer.as_ptr(), true);
                 },
                 FieldType::StringU8 |
                 FieldType::StringU16 |
                 FieldType::OptionalStringU8 |
                 FieldType::OptionalStringU16 => {
                     new_qstring_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, field.get_max_length(), &timer.as_ptr(), true);
-                    new_qstring_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, field.get_max_length(), &timer.as_ptr(), true);
                 },
                 FieldType::SequenceU16(_) | FieldType::SequenceU32(_) => {
                     new_generic_item_delegate_safe(&table_view_primary.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
-                    new_generic_item_delegate_safe(&table_view_frozen.static_upcast::<QObject>().as_ptr(), column as i32, &timer.as_ptr(), true);
                 }
             }
         }
     }
+
+    share_frozen_delegates_safe(&table_view_primary.as_ptr());
 }
 
 /// This function is a generic way to toggle the sort order of a column.